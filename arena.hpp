@@ -0,0 +1,186 @@
+#ifndef ARENA_HPP
+#define ARENA_HPP
+
+#include <cstddef>
+#include <new>
+#include "utils.hpp"
+
+namespace ft
+{
+
+// Monotonic bump-pointer memory. Allocations are never freed one by one,
+// everything goes away at once with reset() or when the arena dies.
+class arena
+{
+public:
+	static const std::size_t default_block_size = 64 * 1024;
+
+	explicit arena(std::size_t block_size = default_block_size) :
+		_head(NULL),
+		_cur(NULL),
+		_end(NULL),
+		_block_size(block_size),
+		_used(0)
+	{
+	}
+	~arena()
+	{
+		release(NULL);
+	}
+
+	void* allocate(std::size_t bytes, std::size_t align)
+	{
+		char* p = align_up(_cur, align);
+		if (!_cur || p + bytes > _end)
+		{
+			grow(bytes + align);
+			p = align_up(_cur, align);
+		}
+		_cur = p + bytes;
+		_used += bytes;
+		return p;
+	}
+
+	// Forgets every allocation. The newest block is kept for the next round.
+	void reset()
+	{
+		if (!_head)
+			return;
+		release(_head);
+		_head->next = NULL;
+		_cur = _head->data();
+		_end = _cur + _head->size;
+		_used = 0;
+	}
+
+	std::size_t used() const { return _used; }
+	std::size_t block_size() const { return _block_size; }
+
+private:
+	struct block
+	{
+		block*		next;
+		std::size_t	size;
+		internal::max_align	pad;
+
+		char* data() { return reinterpret_cast<char*>(this + 1); }
+	};
+
+	arena(const arena&);
+	arena& operator=(const arena&);
+
+	static char* align_up(char* p, std::size_t align)
+	{
+		std::size_t addr = reinterpret_cast<std::size_t>(p);
+		return p + ((align - addr % align) % align);
+	}
+
+	void grow(std::size_t bytes)
+	{
+		std::size_t size = ft::max(bytes, _block_size);
+		block* b = static_cast<block*>(::operator new(sizeof(block) + size));
+		b->next = _head;
+		b->size = size;
+		_head = b;
+		_cur = b->data();
+		_end = _cur + size;
+	}
+
+	// Frees every block but keep
+	void release(block* keep)
+	{
+		block* b = _head;
+		while (b)
+		{
+			block* next = b->next;
+			if (b != keep)
+				::operator delete(b);
+			b = next;
+		}
+		if (!keep)
+			_head = NULL;
+	}
+
+	block*		_head;
+	char*		_cur;
+	char*		_end;
+	std::size_t	_block_size;
+	std::size_t	_used;
+};
+
+// Allocator handing out memory from an ft::arena. deallocate is a no-op,
+// memory comes back when the arena is reset.
+template<typename T>
+class arena_allocator
+{
+public:
+	typedef T			value_type;
+	typedef T*			pointer;
+	typedef const T*	const_pointer;
+	typedef T&			reference;
+	typedef const T&	const_reference;
+	typedef std::size_t	size_type;
+	typedef ptrdiff_t	difference_type;
+
+	template<typename U>
+	struct rebind {
+		typedef arena_allocator<U> other;
+	};
+
+	arena_allocator(arena& a) : _arena(&a) {}
+	arena_allocator(const arena_allocator& other) : _arena(other._arena) {}
+	template<typename U>
+	arena_allocator(const arena_allocator<U>& other) : _arena(other.get_arena()) {}
+	~arena_allocator() {}
+
+	arena_allocator& operator=(const arena_allocator& other)
+	{
+		_arena = other._arena;
+		return *this;
+	}
+
+	pointer allocate(size_type n, const void* hint = NULL)
+	{
+		(void)hint;
+		if (n > max_size())
+			throw std::bad_alloc();
+		return static_cast<pointer>(_arena->allocate(n * sizeof(T), ft::alignment_of<T>::value));
+	}
+	void deallocate(pointer p, size_type n)
+	{
+		(void)p;
+		(void)n;
+	}
+
+	void construct(pointer p, const T& value) { new(static_cast<void*>(p)) T(value); }
+#ifdef FT_CXX11
+	template<typename U, typename... Args>
+	void construct(U* p, Args&&... args) { new(static_cast<void*>(p)) U(std::forward<Args>(args)...); }
+#endif
+	void destroy(pointer p) { p->~T(); }
+
+	pointer address(reference x) const { return &x; }
+	const_pointer address(const_reference x) const { return &x; }
+	size_type max_size() const { return size_type(-1) / sizeof(T); }
+
+	arena* get_arena() const { return _arena; }
+
+private:
+	arena*	_arena;
+};
+
+template<typename T, typename U>
+bool operator==(const arena_allocator<T>& a, const arena_allocator<U>& b)
+{
+	return a.get_arena() == b.get_arena();
+}
+
+template<typename T, typename U>
+bool operator!=(const arena_allocator<T>& a, const arena_allocator<U>& b)
+{
+	return !(a == b);
+}
+
+} //ft
+
+#endif // ARENA_HPP
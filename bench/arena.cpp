@@ -0,0 +1,54 @@
+#include "vector.hpp"
+#include "map.hpp"
+#include "arena.hpp"
+#include "bench.hpp"
+
+static const int rounds = 200;
+static const int vectors_per_request = 2000;
+static const int map_entries = 2000;
+
+// One request: many short vectors and a map, all dropped together
+template<typename IntAlloc, typename PairAlloc>
+std::size_t request(const IntAlloc& int_alloc, const PairAlloc& pair_alloc, int seed)
+{
+	typedef ft::vector<int, IntAlloc>													vec;
+	typedef typename ft::internal::alloc_traits<IntAlloc>::template rebind<vec>::other	vec_alloc;
+
+	ft::vector<vec, vec_alloc> vecs((vec_alloc(int_alloc)));
+	vecs.reserve(vectors_per_request);
+	for (int i = 0; i < vectors_per_request; i++)
+	{
+		vecs.push_back(vec(int_alloc));
+		for (int k = 0; k < (seed + i) % 16 + 1; k++)
+			vecs.back().push_back(k);
+	}
+
+	ft::map<int, int, ft::less<int>, PairAlloc> m((ft::less<int>()), pair_alloc);
+	for (int j = 0; j < map_entries; j++)
+		m.insert(ft::make_pair((j * 7919 + seed) % map_entries, j));
+	return vecs.size() + m.size();
+}
+
+int main()
+{
+	typedef ft::pair<const int, int> value;
+
+	bench::title("request-scoped vectors and maps");
+
+	double start = bench::now();
+	for (int r = 0; r < rounds; r++)
+		bench::consume(request(std::allocator<int>(), std::allocator<value>(), r));
+	double base = bench::now() - start;
+	bench::report("std::allocator", base);
+
+	ft::arena arena;
+	start = bench::now();
+	for (int r = 0; r < rounds; r++)
+	{
+		bench::consume(request(ft::arena_allocator<int>(arena),
+							   ft::arena_allocator<value>(arena), r));
+		arena.reset();
+	}
+	bench::report("ft::arena_allocator + reset", bench::now() - start, base);
+	return 0;
+}
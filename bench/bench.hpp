@@ -0,0 +1,44 @@
+#ifndef BENCH_HPP
+#define BENCH_HPP
+
+#include <sys/time.h>
+#include <cstddef>
+#include <iostream>
+#include <iomanip>
+#include <string>
+
+namespace bench
+{
+
+inline double now()
+{
+	timeval tv;
+	gettimeofday(&tv, NULL);
+	return tv.tv_sec + tv.tv_usec / 1e6;
+}
+
+// Keeps results alive so the optimizer cannot drop the measured work
+inline void consume(std::size_t value)
+{
+	static volatile std::size_t sink;
+	sink = sink + value;
+}
+
+inline void title(const std::string& text)
+{
+	std::cout << "--- " << text << " ---" << std::endl;
+}
+
+inline void report(const std::string& name, double seconds, double baseline = 0)
+{
+	std::cout << std::left << std::setw(36) << name
+			  << std::right << std::fixed << std::setprecision(2)
+			  << std::setw(10) << seconds * 1000 << " ms";
+	if (baseline > 0)
+		std::cout << "  x" << std::setprecision(2) << baseline / seconds;
+	std::cout << std::endl;
+}
+
+} //bench
+
+#endif // BENCH_HPP
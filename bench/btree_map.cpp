@@ -0,0 +1,83 @@
+#include <map>
+#include "map.hpp"
+#include "btree_map.hpp"
+#include "vector.hpp"
+#include "bench.hpp"
+
+static const int entries = 2000000;
+
+struct times
+{
+	double insert;
+	double find;
+	double scan;
+	double erase;
+};
+
+static int key(int i)
+{
+	return static_cast<int>((i * 2654435761u) % (entries * 4u));
+}
+
+template<typename Map, typename Pair>
+times run()
+{
+	times t;
+	Map m;
+	std::size_t sum = 0;
+
+	double start = bench::now();
+	for (int i = 0; i < entries; i++)
+		m.insert(Pair(key(i), i));
+	t.insert = bench::now() - start;
+
+	start = bench::now();
+	for (int i = 0; i < entries; i++)
+		sum += m.count(key(i * 7 % entries)) + m.count(key(i) + 1);
+	t.find = bench::now() - start;
+
+	start = bench::now();
+	for (int r = 0; r < 5; r++)
+		for (typename Map::iterator it = m.begin(); it != m.end(); ++it)
+			sum += (*it).second;
+	t.scan = bench::now() - start;
+
+	start = bench::now();
+	for (int i = 0; i < entries; i += 2)
+		sum += m.erase(key(i));
+	t.erase = bench::now() - start;
+
+	bench::consume(sum);
+	return t;
+}
+
+int main()
+{
+	// Warm-up, so every measured run starts from an already used heap
+	run<std::map<int, int>, std::pair<const int, int> >();
+
+	times base = run<std::map<int, int>, std::pair<const int, int> >();
+	times avl = run<ft::map<int, int>, ft::pair<const int, int> >();
+	times btree = run<ft::btree_map<int, int>, ft::pair<const int, int> >();
+
+	bench::title("random insert");
+	bench::report("std::map", base.insert);
+	bench::report("ft::map", avl.insert, base.insert);
+	bench::report("ft::btree_map", btree.insert, base.insert);
+
+	bench::title("random lookup, half misses");
+	bench::report("std::map", base.find);
+	bench::report("ft::map", avl.find, base.find);
+	bench::report("ft::btree_map", btree.find, base.find);
+
+	bench::title("full scans");
+	bench::report("std::map", base.scan);
+	bench::report("ft::map", avl.scan, base.scan);
+	bench::report("ft::btree_map", btree.scan, base.scan);
+
+	bench::title("erase half");
+	bench::report("std::map", base.erase);
+	bench::report("ft::map", avl.erase, base.erase);
+	bench::report("ft::btree_map", btree.erase, base.erase);
+	return 0;
+}
@@ -0,0 +1,98 @@
+#include <malloc.h>
+#include <map>
+#include "map.hpp"
+#include "compact_map.hpp"
+#include "bench.hpp"
+
+static const int entries = 4000000;
+
+struct result
+{
+	double insert;
+	double find;
+	double scan;
+	double megabytes;
+};
+
+static int key(int i)
+{
+	return static_cast<int>((i * 2654435761u) % (entries * 4u));
+}
+
+// Bytes handed out by malloc, its per chunk bookkeeping included
+static double heapInUse()
+{
+	struct mallinfo2 info = mallinfo2();
+	return static_cast<double>(info.uordblks + info.hblkhd);
+}
+
+template<typename Map, typename Pair>
+result run()
+{
+	result r;
+	const double heap = heapInUse();
+	Map m;
+	std::size_t sum = 0;
+
+	double start = bench::now();
+	for (int i = 0; i < entries; i++)
+		m.insert(Pair(key(i), i));
+	r.insert = bench::now() - start;
+	r.megabytes = (heapInUse() - heap) / (1024 * 1024);
+
+	start = bench::now();
+	for (int i = 0; i < entries; i++)
+		sum += m.count(key(i * 7 % entries)) + m.count(key(i) + 1);
+	r.find = bench::now() - start;
+
+	start = bench::now();
+	for (int n = 0; n < 5; n++)
+		for (typename Map::iterator it = m.begin(); it != m.end(); ++it)
+			sum += (*it).second;
+	r.scan = bench::now() - start;
+
+	bench::consume(sum);
+	return r;
+}
+
+static void footprint(const std::string& name, const result& r, const result& base)
+{
+	std::cout << std::left << std::setw(36) << name
+			  << std::right << std::fixed << std::setprecision(2)
+			  << std::setw(10) << r.megabytes << " MB"
+			  << "  " << r.megabytes * 1024 * 1024 / entries << " B/entry";
+	if (&r != &base)
+		std::cout << "  x" << base.megabytes / r.megabytes;
+	std::cout << std::endl;
+}
+
+int main()
+{
+	// Warm-up, so every measured run starts from an already used heap
+	run<std::map<int, int>, std::pair<const int, int> >();
+
+	result base = run<std::map<int, int>, std::pair<const int, int> >();
+	result avl = run<ft::map<int, int>, ft::pair<const int, int> >();
+	result compact = run<ft::compact_map<int, int>, ft::pair<const int, int> >();
+
+	bench::title("memory, 4M int pairs");
+	footprint("std::map", base, base);
+	footprint("ft::map", avl, base);
+	footprint("ft::compact_map", compact, base);
+
+	bench::title("random insert");
+	bench::report("std::map", base.insert);
+	bench::report("ft::map", avl.insert, base.insert);
+	bench::report("ft::compact_map", compact.insert, base.insert);
+
+	bench::title("random lookup, half misses");
+	bench::report("std::map", base.find);
+	bench::report("ft::map", avl.find, base.find);
+	bench::report("ft::compact_map", compact.find, base.find);
+
+	bench::title("full scans");
+	bench::report("std::map", base.scan);
+	bench::report("ft::map", avl.scan, base.scan);
+	bench::report("ft::compact_map", compact.scan, base.scan);
+	return 0;
+}
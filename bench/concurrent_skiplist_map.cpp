@@ -0,0 +1,112 @@
+#include "concurrent_skiplist_map.hpp"
+#include "bench.hpp"
+
+#ifdef FT_CXX11
+
+#include <mutex>
+#include <thread>
+#include <vector>
+
+static const int keys = 1 << 18;
+static const int ops = 2000000;
+
+// The baseline, a single lock around the whole map
+class locked_map
+{
+public:
+	bool find(int key) const
+	{
+		std::lock_guard<std::mutex> lock(_lock);
+		return _m.find(key) != _m.end();
+	}
+	void write(int key, int value)
+	{
+		std::lock_guard<std::mutex> lock(_lock);
+		if (key & 1)
+			_m.erase(key);
+		else
+			_m.insert(ft::make_pair(key, value));
+	}
+
+private:
+	mutable std::mutex	_lock;
+	ft::map<int, int>	_m;
+};
+
+class skiplist
+{
+public:
+	bool find(int key) const { return _m.find(key) != _m.end(); }
+	void write(int key, int value)
+	{
+		if (key & 1)
+			_m.erase(key);
+		else
+			_m.insert(ft::make_pair(key, value));
+	}
+
+private:
+	ft::concurrent_skiplist_map<int, int>	_m;
+};
+
+// The threads share ops between them, writing one op in writes_per_100
+template <typename Map>
+static double run(unsigned threads, int writes_per_100)
+{
+	Map m;
+	for (int i = 0; i < keys; i += 2)
+		m.write(i, i);
+
+	std::vector<std::thread> workers;
+	const double start = bench::now();
+	for (unsigned t = 0; t < threads; t++)
+		workers.emplace_back([&m, t, threads, writes_per_100]()
+		{
+			unsigned x = 2463534242u + t;
+			std::size_t hits = 0;
+			for (int i = 0; i < ops / static_cast<int>(threads); i++)
+			{
+				x ^= x << 13;
+				x ^= x >> 17;
+				x ^= x << 5;
+				const int key = static_cast<int>(x % keys);
+				if (static_cast<int>(x >> 24) % 100 < writes_per_100)
+					m.write(key, i);
+				else
+					hits += m.find(key);
+			}
+			bench::consume(hits);
+		});
+	for (std::size_t t = 0; t < workers.size(); t++)
+		workers[t].join();
+	return bench::now() - start;
+}
+
+int main()
+{
+	const unsigned cores = std::thread::hardware_concurrency();
+	const int workloads[] = { 0, 10, 50 };
+	const char* names[] = { "lookups only", "10% writes", "50% writes" };
+
+	for (unsigned threads = 1; threads <= cores || threads <= 4; threads *= 2)
+	{
+		bench::title(std::to_string(threads) + " threads, 2M ops on 256K keys");
+		for (int w = 0; w < 3; w++)
+		{
+			const double base = run<locked_map>(threads, workloads[w]);
+			bench::report(std::string(names[w]) + ", mutex", base);
+			bench::report(std::string(names[w]) + ", skip list", run<skiplist>(threads, workloads[w]), base);
+		}
+	}
+	return 0;
+}
+
+#else
+
+int main()
+{
+	std::cout << "needs C++11, build with STD=c++11" << std::endl;
+	return 0;
+}
+
+#endif
@@ -0,0 +1,81 @@
+#include "vector.hpp"
+#include "cow_vector.hpp"
+#include "bench.hpp"
+
+static const int elements = 1000000;
+static const int handoffs = 1000;
+
+typedef ft::vector<int>		vector_type;
+typedef ft::cow_vector<int>	cow_type;
+
+// Passed by value down a call chain, read and never changed
+template <typename Vector>
+static std::size_t readCopy(Vector v, int i)
+{
+	const Vector& cv = v;
+	return cv[i % cv.size()] + cv.size();
+}
+
+template <typename Vector>
+static double handOff(const Vector& v)
+{
+	std::size_t sum = 0;
+	const double start = bench::now();
+	for (int i = 0; i < handoffs; i++)
+		sum += readCopy(v, i);
+	bench::consume(sum);
+	return bench::now() - start;
+}
+
+// Copies changed once each, paying for the copy on the first write
+template <typename Vector, typename Source>
+static double writeCopies(const Source& elements)
+{
+	std::size_t sum = 0;
+	const double start = bench::now();
+	for (int i = 0; i < handoffs / 10; i++)
+	{
+		Vector copy(elements);
+		copy[i] = i;
+		sum += copy[i + 1];
+	}
+	bench::consume(sum);
+	return bench::now() - start;
+}
+
+template <typename Vector>
+static double pushBacks()
+{
+	const double start = bench::now();
+	Vector v;
+	for (int i = 0; i < elements * 10; i++)
+		v.push_back(i);
+	bench::consume(v.size());
+	return bench::now() - start;
+}
+
+int main()
+{
+	vector_type v;
+	for (int i = 0; i < elements; i++)
+		v.push_back(i);
+	const cow_type c(v);
+
+	bench::title("100 copies written once");
+	// Both copying the same elements, first as the hand-offs leave the heap
+	// in a state slowing down large allocations
+	const double write = writeCopies<vector_type>(c.get());
+	bench::report("ft::vector", write);
+	bench::report("cow_vector", writeCopies<cow_type>(c), write);
+
+	bench::title("1000 hand-offs by value of 1M ints");
+	const double base = handOff(v);
+	bench::report("ft::vector", base);
+	bench::report("cow_vector", handOff(c), base);
+
+	bench::title("10M push_back, unshared");
+	const double push = pushBacks<vector_type>();
+	bench::report("ft::vector", push);
+	bench::report("cow_vector", pushBacks<cow_type>(), push);
+	return 0;
+}
@@ -0,0 +1,80 @@
+#include "map.hpp"
+#include "bench.hpp"
+
+#ifdef FT_CXX11
+
+#include <thread>
+#include <vector>
+
+typedef ft::map<int, int>	map_type;
+
+static const int entries = 8000000;
+
+struct times
+{
+	double build;
+	double copy;
+	double scan;
+	double clear;
+};
+
+static times run(ft::thread_pool& pool, const std::vector<ft::pair<int, int> >& sorted)
+{
+	times t;
+
+	double start = bench::now();
+	map_type m(ft::from_sorted, sorted.begin(), sorted.end(), pool);
+	t.build = bench::now() - start;
+
+	start = bench::now();
+	map_type copy(m, pool);
+	t.copy = bench::now() - start;
+
+	start = bench::now();
+	ft::parallel_for_each(copy, [](ft::pair<const int, int>& p) { p.second = p.second * 3 + 1; }, pool);
+	t.scan = bench::now() - start;
+
+	start = bench::now();
+	copy.clear(pool);
+	m.clear(pool);
+	t.clear = bench::now() - start;
+	return t;
+}
+
+int main()
+{
+	std::vector<ft::pair<int, int> > sorted;
+	for (int i = 0; i < entries; i++)
+		sorted.push_back(ft::make_pair(i * 2, i));
+
+	const unsigned cores = std::thread::hardware_concurrency();
+	ft::thread_pool single(1);
+	run(single, sorted);
+	const times base = run(single, sorted);
+	bench::title("1 thread, 8M entries");
+	bench::report("sorted build", base.build);
+	bench::report("copy", base.copy);
+	bench::report("parallel_for_each", base.scan);
+	bench::report("clear x2", base.clear);
+	for (unsigned threads = 2; threads <= cores || threads == 2; threads *= 2)
+	{
+		ft::thread_pool pool(threads);
+		const times t = run(pool, sorted);
+		bench::title(std::to_string(threads) + " threads, 8M entries");
+		bench::report("sorted build", t.build, base.build);
+		bench::report("copy", t.copy, base.copy);
+		bench::report("parallel_for_each", t.scan, base.scan);
+		bench::report("clear x2", t.clear, base.clear);
+	}
+	return 0;
+}
+
+#else
+
+int main()
+{
+	std::cout << "needs C++11, build with STD=c++11" << std::endl;
+	return 0;
+}
+
+#endif
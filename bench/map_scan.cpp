@@ -0,0 +1,64 @@
+#include "map.hpp"
+#include "bench.hpp"
+
+static const int entries = 1000000;
+static const int full_scans = 20;
+static const int range_scans = 200000;
+static const int range_length = 64;
+
+// Keys are inserted in a scattered order so neighbours in the tree are not
+// neighbours in memory
+template<typename Map>
+void fill(Map& m)
+{
+	for (int i = 0; i < entries; i++)
+		m.insert(ft::make_pair(static_cast<int>((i * 2654435761u) % entries), i));
+}
+
+template<typename Map>
+double scan(const Map& m)
+{
+	double start = bench::now();
+	std::size_t sum = 0;
+	for (int r = 0; r < full_scans; r++)
+		for (typename Map::const_iterator it = m.begin(); it != m.end(); ++it)
+			sum += (*it).second;
+	bench::consume(sum);
+	return bench::now() - start;
+}
+
+template<typename Map>
+double range(const Map& m)
+{
+	double start = bench::now();
+	std::size_t sum = 0;
+	for (int r = 0; r < range_scans; r++)
+	{
+		typename Map::const_iterator it = m.lower_bound(static_cast<int>((r * 40503u) % entries));
+		for (int n = 0; n < range_length && it != m.end(); n++, ++it)
+			sum += (*it).second;
+	}
+	bench::consume(sum);
+	return bench::now() - start;
+}
+
+int main()
+{
+	typedef std::allocator<ft::pair<const int, int> >	alloc;
+
+	ft::map<int, int> plain;
+	ft::map<int, int, ft::less<int>, alloc, true> threaded;
+	fill(plain);
+	fill(threaded);
+
+	bench::title("full scans");
+	double base = scan(plain);
+	bench::report("parent links", base);
+	bench::report("threaded", scan(threaded), base);
+
+	bench::title("range scans");
+	base = range(plain);
+	bench::report("parent links", base);
+	bench::report("threaded", range(threaded), base);
+	return 0;
+}
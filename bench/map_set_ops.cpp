@@ -0,0 +1,66 @@
+#include "map.hpp"
+#include "bench.hpp"
+
+typedef ft::map<int, int>	map_type;
+
+static const int entries = 2000000;
+
+int main()
+{
+	map_type snapshot;
+	map_type delta;
+	for (int i = 0; i < entries; i++)
+		snapshot.insert(snapshot.end(), ft::make_pair(i * 2, i));
+	for (int i = 0; i < entries; i++)
+		delta.insert(delta.end(), ft::make_pair(i * 3, -i));
+
+	bench::title("union, 2M + 2M keys");
+	double start = bench::now();
+	{
+		map_type res(snapshot);
+		for (map_type::iterator it = delta.begin(); it != delta.end(); ++it)
+			res.insert(*it);
+		bench::consume(res.size());
+	}
+	const double loop = bench::now() - start;
+	bench::report("copy and insert", loop);
+	start = bench::now();
+	bench::consume(ft::map_union(snapshot, delta).size());
+	bench::report("ft::map_union", bench::now() - start, loop);
+
+	bench::title("intersection");
+	start = bench::now();
+	{
+		map_type res;
+		for (map_type::iterator it = snapshot.begin(); it != snapshot.end(); ++it)
+			if (delta.count((*it).first))
+				res.insert(res.end(), *it);
+		bench::consume(res.size());
+	}
+	const double lookups = bench::now() - start;
+	bench::report("find and insert", lookups);
+	start = bench::now();
+	bench::consume(ft::map_intersection(snapshot, delta).size());
+	bench::report("ft::map_intersection", bench::now() - start, lookups);
+
+	bench::title("merge");
+	map_type a(snapshot);
+	map_type b(delta);
+	start = bench::now();
+	for (map_type::iterator it = b.begin(); it != b.end();)
+	{
+		if (a.insert(*it).second)
+			b.erase(it++);
+		else
+			++it;
+	}
+	const double moves = bench::now() - start;
+	bench::report("insert and erase", moves);
+	map_type c(snapshot);
+	map_type d(delta);
+	start = bench::now();
+	c.merge(d);
+	bench::report("map::merge", bench::now() - start, moves);
+	bench::consume(a.size() + c.size());
+	return 0;
+}
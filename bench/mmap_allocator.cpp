@@ -0,0 +1,46 @@
+#include "vector.hpp"
+#include "mmap_allocator.hpp"
+#include "bench.hpp"
+
+static const int elements = 50000000;
+
+template<typename Vector>
+double pushBacks()
+{
+	double start = bench::now();
+	Vector v;
+	for (int i = 0; i < elements; i++)
+		v.push_back(i);
+	bench::consume(v.size());
+	return bench::now() - start;
+}
+
+#ifdef FT_CXX11
+template<typename Vector>
+double emplaceBacks()
+{
+	double start = bench::now();
+	Vector v;
+	for (int i = 0; i < elements; i++)
+		v.emplace_back(i);
+	bench::consume(v.size());
+	return bench::now() - start;
+}
+#endif
+
+int main()
+{
+	typedef ft::vector<long> plain;
+	typedef ft::vector<long, ft::mmap_allocator<long> > mapped;
+
+	bench::title("50M longs, growing from empty");
+	double base = pushBacks<plain>();
+	bench::report("push_back, std::allocator", base);
+	bench::report("push_back, ft::mmap_allocator", pushBacks<mapped>(), base);
+#ifdef FT_CXX11
+	base = emplaceBacks<plain>();
+	bench::report("emplace_back, std::allocator", base);
+	bench::report("emplace_back, ft::mmap_allocator", emplaceBacks<mapped>(), base);
+#endif
+	return 0;
+}
@@ -0,0 +1,45 @@
+#include "map.hpp"
+#include "pool_allocator.hpp"
+#include "bench.hpp"
+
+static const int keys = 200000;
+static const int churn = 2000000;
+
+// Keeps the map around a fixed size while replacing random keys
+template<typename Map>
+double run(Map& m)
+{
+	double start = bench::now();
+	for (int i = 0; i < keys; i++)
+		m.insert(ft::make_pair(i * 2, i));
+	unsigned int seed = 42;
+	for (int i = 0; i < churn; i++)
+	{
+		seed = seed * 1103515245 + 12345;
+		int key = (seed >> 8) % keys * 2;
+		m.erase(key);
+		m.insert(ft::make_pair(key + (i & 1), i));
+	}
+	std::size_t sum = 0;
+	for (typename Map::iterator it = m.begin(); it != m.end(); ++it)
+		sum += (*it).second;
+	bench::consume(sum);
+	m.clear();
+	return bench::now() - start;
+}
+
+int main()
+{
+	typedef ft::pair<const int, int> value;
+
+	bench::title("map insert/erase churn");
+	{
+		ft::map<int, int> m;
+		double base = run(m);
+		bench::report("std::allocator", base);
+
+		ft::map<int, int, ft::less<int>, ft::pool_allocator<value> > p;
+		bench::report("ft::pool_allocator", run(p), base);
+	}
+	return 0;
+}
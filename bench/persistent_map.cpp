@@ -0,0 +1,119 @@
+#include "map.hpp"
+#include "persistent_map.hpp"
+#include "vector.hpp"
+#include "bench.hpp"
+
+static const int entries = 1000000;
+static const int writes = 200000;
+static const int snapshots = 20;
+
+typedef ft::map<int, int>				map_type;
+typedef ft::persistent_map<int, int>	persistent_type;
+
+static unsigned int next(unsigned int& x)
+{
+	x ^= x << 13;
+	x ^= x >> 17;
+	x ^= x << 5;
+	return x;
+}
+
+// Writes with a snapshot taken every writes / snapshots of them, the
+// snapshots being kept alive by readers until the end
+template <typename Map>
+static double writeWithSnapshots(Map& m, ft::vector<Map>& readers)
+{
+	unsigned int x = 12345;
+	const double start = bench::now();
+	for (int i = 0; i < writes; i++)
+	{
+		const int key = static_cast<int>(next(x) % (entries * 2));
+		if (key & 1)
+			m.erase(key - 1);
+		else
+			m.insert(ft::make_pair(key, i));
+		if (i % (writes / snapshots) == 0)
+		{
+			readers.push_back(Map());
+			readers.back() = m;
+		}
+	}
+	return bench::now() - start;
+}
+
+template <typename Map>
+static double lookups(const Map& m)
+{
+	unsigned int x = 54321;
+	std::size_t hits = 0;
+	const double start = bench::now();
+	for (int i = 0; i < writes; i++)
+		hits += m.count(static_cast<int>(next(x) % (entries * 2)));
+	bench::consume(hits);
+	return bench::now() - start;
+}
+
+int main()
+{
+	map_type m;
+	persistent_type p;
+	double start = bench::now();
+	for (int i = 0; i < entries; i++)
+		m.insert(ft::make_pair(i * 2, i));
+	const double mapInsert = bench::now() - start;
+	start = bench::now();
+	for (int i = 0; i < entries; i++)
+		p.insert(ft::make_pair(i * 2, i));
+	const double persistentInsert = bench::now() - start;
+
+	bench::title("1M inserts");
+	bench::report("ft::map", mapInsert);
+	bench::report("persistent_map", persistentInsert, mapInsert);
+
+	bench::title("snapshot of 1M entries");
+	start = bench::now();
+	map_type copy;
+	copy = m;
+	const double mapCopy = bench::now() - start;
+	bench::consume(copy.size());
+	persistent_type snap;
+	start = bench::now();
+	for (int i = 0; i < 1000; i++)
+		snap = p.snapshot();
+	const double persistentCopy = bench::now() - start;
+	bench::consume(snap.size());
+	bench::report("ft::map operator=", mapCopy);
+	bench::report("persistent_map snapshot() x1000", persistentCopy, mapCopy);
+
+	bench::title("200K writes, 20 snapshots kept alive");
+	{
+		ft::vector<map_type> readers;
+		const double base = writeWithSnapshots(m, readers);
+		bench::report("ft::map", base);
+		ft::vector<persistent_type> persistentReaders;
+		bench::report("persistent_map", writeWithSnapshots(p, persistentReaders), base);
+	}
+
+	bench::title("200K writes, no snapshot alive");
+	{
+		snap.clear();
+		unsigned int x = 999;
+		start = bench::now();
+		for (int i = 0; i < writes; i++)
+			p.insert_or_assign(static_cast<int>(next(x) % (entries * 2)), i);
+		const double unshared = bench::now() - start;
+		x = 999;
+		start = bench::now();
+		for (int i = 0; i < writes; i++)
+			m[static_cast<int>(next(x) % (entries * 2))] = i;
+		const double base = bench::now() - start;
+		bench::report("ft::map operator[]", base);
+		bench::report("persistent_map insert_or_assign", unshared, base);
+	}
+
+	bench::title("200K lookups");
+	const double base = lookups(m);
+	bench::report("ft::map", base);
+	bench::report("persistent_map", lookups(p), base);
+	return 0;
+}
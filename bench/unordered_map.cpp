@@ -0,0 +1,84 @@
+#include <map>
+#include "map.hpp"
+#include "unordered_map.hpp"
+#include "bench.hpp"
+#ifdef FT_CXX11
+# include <unordered_map>
+#else
+# include <tr1/unordered_map>
+#endif
+
+#ifdef FT_CXX11
+typedef std::unordered_map<int, int>		std_unordered_map;
+#else
+typedef std::tr1::unordered_map<int, int>	std_unordered_map;
+#endif
+
+static const int entries = 2000000;
+
+struct times
+{
+	double insert;
+	double find;
+	double erase;
+};
+
+static int key(int i)
+{
+	return static_cast<int>((i * 2654435761u) % (entries * 4u));
+}
+
+template<typename Map, typename Pair>
+times run()
+{
+	times t;
+	Map m;
+	std::size_t sum = 0;
+
+	double start = bench::now();
+	for (int i = 0; i < entries; i++)
+		m.insert(Pair(key(i), i));
+	t.insert = bench::now() - start;
+
+	start = bench::now();
+	for (int r = 0; r < 2; r++)
+		for (int i = 0; i < entries; i++)
+			sum += m.count(key(i * 7 % entries)) + m.count(key(i) + 1);
+	t.find = bench::now() - start;
+
+	start = bench::now();
+	for (int i = 0; i < entries; i += 2)
+		sum += m.erase(key(i));
+	for (int i = 0; i < entries; i++)
+		sum += m.count(key(i));
+	t.erase = bench::now() - start;
+
+	bench::consume(sum);
+	return t;
+}
+
+int main()
+{
+	// Warm-up, so every measured run starts from an already used heap
+	run<std_unordered_map, std::pair<const int, int> >();
+
+	times base = run<std_unordered_map, std::pair<const int, int> >();
+	times tree = run<ft::map<int, int>, ft::pair<const int, int> >();
+	times swiss = run<ft::unordered_map<int, int>, ft::pair<const int, int> >();
+
+	bench::title("random insert");
+	bench::report("std::unordered_map", base.insert);
+	bench::report("ft::map", tree.insert, base.insert);
+	bench::report("ft::unordered_map", swiss.insert, base.insert);
+
+	bench::title("random lookup, half misses");
+	bench::report("std::unordered_map", base.find);
+	bench::report("ft::map", tree.find, base.find);
+	bench::report("ft::unordered_map", swiss.find, base.find);
+
+	bench::title("erase half, then lookup all");
+	bench::report("std::unordered_map", base.erase);
+	bench::report("ft::map", tree.erase, base.erase);
+	bench::report("ft::unordered_map", swiss.erase, base.erase);
+	return 0;
+}
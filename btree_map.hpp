@@ -0,0 +1,960 @@
+#ifndef BTREE_MAP_HPP
+#define BTREE_MAP_HPP
+
+#include <memory>
+#include <stdexcept>
+#include "iterator.hpp"
+#include "utils.hpp"
+#include "compare.hpp"
+#include "vector.hpp"
+
+namespace ft
+{
+
+// B+tree keeping its elements in sorted arrays inside nodes of about
+// NodeSize bytes, so a lookup touches a few cache lines per level instead
+// of one node per comparison. Values live in the leaves, which are linked
+// together for iteration, inner nodes only hold copies of keys.
+// Unlike ft::map, inserting or erasing invalidates every iterator.
+template <typename Key, typename T, typename Compare = ft::less<Key>,
+	typename Allocator = std::allocator<ft::pair<const Key, T> >, std::size_t NodeSize = 256>
+class btree_map
+{
+private:
+	struct Node;
+	struct Leaf;
+	struct Inner;
+	typedef internal::alloc_traits<Allocator>	alloc_traits;
+
+public:
+	typedef Allocator									allocator_type;
+	typedef typename alloc_traits::value_type			value_type;
+	typedef Compare										key_compare;
+	typedef Key											key_type;
+	typedef T											data_type;
+	typedef T											mapped_type;
+	typedef typename alloc_traits::pointer				pointer;
+	typedef typename alloc_traits::const_pointer		const_pointer;
+	typedef typename alloc_traits::reference			reference;
+	typedef typename alloc_traits::const_reference		const_reference;
+	typedef typename alloc_traits::size_type			size_type;
+	typedef typename alloc_traits::difference_type		difference_type;
+	typedef typename alloc_traits::template rebind<Leaf>::other	leaf_allocator;
+	typedef typename alloc_traits::template rebind<Inner>::other	inner_allocator;
+	typedef typename alloc_traits::template rebind<key_type>::other	key_allocator;
+
+	class value_compare : public ft::binary_function<value_type, value_type, bool>
+	{
+	public:
+		value_compare(Compare c) : comp(c) {}
+
+		bool operator()(const value_type& lhs, const value_type& rhs) const {
+			return comp(lhs.first, rhs.first);
+		}
+
+	protected:
+		Compare comp;
+	};
+
+	// Elements per leaf and keys per inner node
+	enum
+	{
+		leaf_slots = (NodeSize / sizeof(value_type) > 4) ? NodeSize / sizeof(value_type) : 4,
+		inner_slots = (NodeSize / (sizeof(key_type) + sizeof(void*)) > 4) ?
+			NodeSize / (sizeof(key_type) + sizeof(void*)) : 4
+	};
+
+	template<typename DataType>
+	class BtreeIterator
+	{
+	public:
+		typedef DataType								value_type;
+		typedef DataType*								pointer;
+		typedef DataType&								reference;
+		typedef ft::bidirectional_iterator_tag			iterator_category;
+		typedef typename alloc_traits::difference_type	difference_type;
+
+		BtreeIterator() :
+			_leaf(NULL),
+			_idx(0)
+		{}
+		BtreeIterator(Leaf* leaf, size_type idx) :
+			_leaf(leaf),
+			_idx(idx)
+		{}
+		template<typename U>
+		BtreeIterator(const BtreeIterator<U>& other) :
+			_leaf(other.leaf()),
+			_idx(other.index())
+		{}
+
+		reference operator*() const { return _leaf->values()[_idx]; }
+		pointer operator->() const { return &operator*(); }
+
+		// The end is one past the last element of the last leaf
+		BtreeIterator& operator++() {
+			if (++_idx == _leaf->count && _leaf->next)
+			{
+				_leaf = _leaf->next;
+				_idx = 0;
+			}
+			return *this;
+		}
+		BtreeIterator operator++(int)
+		{
+			BtreeIterator tmp = *this;
+			++*this;
+			return tmp;
+		}
+
+		BtreeIterator& operator--() {
+			if (_idx == 0)
+			{
+				_leaf = _leaf->prev;
+				_idx = _leaf->count;
+			}
+			--_idx;
+			return *this;
+		}
+		BtreeIterator operator--(int)
+		{
+			BtreeIterator tmp = *this;
+			--*this;
+			return tmp;
+		}
+
+		bool operator==(const BtreeIterator& other) const { return _leaf == other._leaf && _idx == other._idx; }
+		bool operator!=(const BtreeIterator& other) const { return !(*this == other); }
+
+		Leaf* leaf() const { return _leaf; }
+		size_type index() const { return _idx; }
+
+	private:
+		Leaf*		_leaf;
+		size_type	_idx;
+	};
+
+	typedef BtreeIterator<value_type>					iterator;
+	typedef BtreeIterator<const value_type>				const_iterator;
+	typedef ft::reverse_iterator<iterator>				reverse_iterator;
+	typedef ft::reverse_iterator<const_iterator>		const_reverse_iterator;
+
+private:
+	typedef internal::alloc_traits<key_allocator>	key_traits;
+
+	enum
+	{
+		min_leaf = leaf_slots / 2,
+		min_inner = inner_slots / 2
+	};
+
+	// Nodes are allocated raw, only the elements and keys they hold are
+	// constructed. pos is the node's index in its parent's children.
+	struct Node
+	{
+		Inner*			parent;
+		unsigned int	pos;
+		unsigned int	count;
+		bool			leaf;
+	};
+
+	struct Leaf : public Node
+	{
+		value_type* values() { return reinterpret_cast<value_type*>(storage.bytes); }
+
+		Leaf*	prev;
+		Leaf*	next;
+		union
+		{
+			char		bytes[leaf_slots * sizeof(value_type)];
+			long double	align_ld;
+			long long	align_ll;
+			void*		align_ptr;
+		}		storage;
+	};
+
+	// Child i holds the keys below keys[i], child i + 1 the ones from it
+	// on. The spare slot lets a full node take one more key before it splits.
+	struct Inner : public Node
+	{
+		key_type* keys() { return reinterpret_cast<key_type*>(storage.bytes); }
+
+		Node*	children[inner_slots + 2];
+		union
+		{
+			char		bytes[(inner_slots + 1) * sizeof(key_type)];
+			long double	align_ld;
+			long long	align_ll;
+			void*		align_ptr;
+		}		storage;
+	};
+
+public:
+	//constructors
+	btree_map() :
+		_root(NULL),
+		_first(NULL),
+		_last(NULL),
+		_size(0),
+		_comp(Compare()),
+		_alloc(Allocator()),
+		_leaf_alloc(_alloc),
+		_inner_alloc(_alloc),
+		_key_alloc(_alloc)
+	{
+	}
+	explicit btree_map(const key_compare& comp, const allocator_type& alloc = allocator_type()) :
+		_root(NULL),
+		_first(NULL),
+		_last(NULL),
+		_size(0),
+		_comp(comp),
+		_alloc(alloc),
+		_leaf_alloc(_alloc),
+		_inner_alloc(_alloc),
+		_key_alloc(_alloc)
+	{
+	}
+	template <typename InputIt>
+	btree_map(InputIt first, InputIt last, const key_compare& comp = key_compare(),
+		const allocator_type& alloc = allocator_type(),
+	typename ft::enable_if<!ft::is_integral<InputIt>::value, InputIt>::type* = NULL) :
+		_root(NULL),
+		_first(NULL),
+		_last(NULL),
+		_size(0),
+		_comp(comp),
+		_alloc(alloc),
+		_leaf_alloc(_alloc),
+		_inner_alloc(_alloc),
+		_key_alloc(_alloc)
+	{
+		insert(first, last);
+	}
+	btree_map(const btree_map& other) :
+		_root(NULL),
+		_first(NULL),
+		_last(NULL),
+		_size(0),
+		_comp(other._comp),
+		_alloc(other._alloc),
+		_leaf_alloc(other._leaf_alloc),
+		_inner_alloc(other._inner_alloc),
+		_key_alloc(other._key_alloc)
+	{
+		*this = other;
+	}
+	btree_map& operator=(const btree_map& other)
+	{
+		if (this == &other)
+			return *this;
+		clear();
+
+		_comp = other._comp;
+		_alloc = other._alloc;
+		_leaf_alloc = other._leaf_alloc;
+		_inner_alloc = other._inner_alloc;
+		_key_alloc = other._key_alloc;
+		insert(other.begin(), other.end());
+		return *this;
+	}
+
+#ifdef FT_CXX11
+	btree_map(btree_map&& other) :
+		_root(other._root),
+		_first(other._first),
+		_last(other._last),
+		_size(other._size),
+		_comp(std::move(other._comp)),
+		_alloc(other._alloc),
+		_leaf_alloc(other._leaf_alloc),
+		_inner_alloc(other._inner_alloc),
+		_key_alloc(other._key_alloc)
+	{
+		other._root = NULL;
+		other._first = NULL;
+		other._last = NULL;
+		other._size = 0;
+	}
+	btree_map& operator=(btree_map&& other)
+	{
+		if (this == &other)
+			return *this;
+		clear();
+		swap(other);
+		return *this;
+	}
+#endif
+
+	~btree_map()
+	{
+		clear();
+	}
+
+	allocator_type get_allocator() const { return _alloc; }
+
+	//element access
+	T& at(const key_type& key)
+	{
+		iterator it = find(key);
+		if (it == end())
+			throw std::out_of_range("btree_map::at");
+		return (*it).second;
+	}
+	const T& at(const key_type& key) const
+	{
+		const_iterator it = find(key);
+		if (it == end())
+			throw std::out_of_range("btree_map::at");
+		return (*it).second;
+	}
+	T& operator[](const key_type& key)
+	{
+		Leaf* leaf;
+		size_type idx;
+		if (!findSlot(key, leaf, idx))
+			constructAt(leaf, idx, value_type(key, mapped_type()));
+		return leaf->values()[idx].second;
+	}
+
+	//iterators
+	iterator begin() { return iterator(_first, 0); }
+	const_iterator begin() const { return const_iterator(_first, 0); }
+	iterator end() { return iterator(_last, _last ? _last->count : 0); }
+	const_iterator end() const { return const_iterator(_last, _last ? _last->count : 0); }
+
+	reverse_iterator rbegin() { return reverse_iterator(end()); }
+	const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+	reverse_iterator rend() { return reverse_iterator(begin()); }
+	const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+	//capacity
+	bool empty() const { return _size == 0; }
+	size_type size() const { return _size; }
+	size_type max_size() const { return alloc_traits::max_size(_alloc); }
+
+	//modifiers
+	void clear()
+	{
+		if (_root)
+			destroyTree(_root);
+		_root = NULL;
+		_first = NULL;
+		_last = NULL;
+		_size = 0;
+	}
+
+	ft::pair<iterator,bool> insert(const value_type& value)
+	{
+		Leaf* leaf;
+		size_type idx;
+		if (findSlot(value.first, leaf, idx))
+			return ft::make_pair(iterator(leaf, idx), false);
+		constructAt(leaf, idx, value);
+		return ft::make_pair(iterator(leaf, idx), true);
+	}
+#ifdef FT_CXX11
+	ft::pair<iterator,bool> insert(value_type&& value)
+	{
+		Leaf* leaf;
+		size_type idx;
+		if (findSlot(value.first, leaf, idx))
+			return ft::make_pair(iterator(leaf, idx), false);
+		constructAt(leaf, idx, std::move(value));
+		return ft::make_pair(iterator(leaf, idx), true);
+	}
+	template<typename... Args>
+	ft::pair<iterator,bool> emplace(Args&&... args)
+	{
+		return insert(value_type(std::forward<Args>(args)...));
+	}
+#endif
+	// Only the end() hint is used: keys past the last one are appended to
+	// the last leaf without a descent
+	iterator insert(iterator position, const value_type& value)
+	{
+		Leaf* leaf = _last;
+		size_type idx = _last ? _last->count : 0;
+		if (position != end() || !_last
+			|| !_comp(_last->values()[idx - 1].first, value.first))
+		{
+			if (findSlot(value.first, leaf, idx))
+				return iterator(leaf, idx);
+		}
+		constructAt(leaf, idx, value);
+		return iterator(leaf, idx);
+	}
+	template <typename InputIt>
+	void insert(InputIt first, InputIt last,
+	typename ft::enable_if<!ft::is_integral<InputIt>::value, InputIt>::type* = NULL)
+	{
+		for (; first != last; ++first)
+			insert(end(), *first);
+	}
+
+	void erase(iterator position)
+	{
+		eraseAt(position.leaf(), position.index());
+	}
+	void erase(iterator first, iterator last)
+	{
+		for (size_type n = ft::distance(first, last); n > 0; n--)
+			first = eraseAt(first.leaf(), first.index());
+	}
+	size_type erase(const key_type& key)
+	{
+		iterator it = find(key);
+		if (it == end())
+			return 0;
+		erase(it);
+		return 1;
+	}
+
+	void swap(btree_map& other)
+	{
+		ft::swap(_root, other._root);
+		ft::swap(_first, other._first);
+		ft::swap(_last, other._last);
+		ft::swap(_size, other._size);
+		ft::swap(_comp, other._comp);
+		ft::swap(_alloc, other._alloc);
+		ft::swap(_leaf_alloc, other._leaf_alloc);
+		ft::swap(_inner_alloc, other._inner_alloc);
+		ft::swap(_key_alloc, other._key_alloc);
+	}
+
+	//lookup
+	size_type count(const key_type& key) const { return find(key) != end(); }
+	iterator find(const key_type& key)
+	{
+		iterator it = lower_bound(key);
+		if (it == end() || _comp(key, (*it).first))
+			return end();
+		return it;
+	}
+	const_iterator find(const key_type& key) const
+	{
+		const_iterator it = lower_bound(key);
+		if (it == end() || _comp(key, (*it).first))
+			return end();
+		return it;
+	}
+	ft::pair<iterator,iterator> equal_range(const key_type& key) {
+		return ft::make_pair(lower_bound(key), upper_bound(key));
+	}
+	ft::pair<const_iterator,const_iterator> equal_range(const key_type& key) const {
+		return ft::make_pair(lower_bound(key), upper_bound(key));
+	}
+
+	iterator lower_bound(const key_type& key) {
+		if (!_root)
+			return end();
+		Leaf* leaf = findLeaf(key);
+		return position(leaf, lowerIndex(leaf, key));
+	}
+	const_iterator lower_bound(const key_type& key) const {
+		if (!_root)
+			return end();
+		Leaf* leaf = findLeaf(key);
+		return position(leaf, lowerIndex(leaf, key));
+	}
+
+	iterator upper_bound(const key_type& key) {
+		if (!_root)
+			return end();
+		Leaf* leaf = findLeaf(key);
+		return position(leaf, upperIndex(leaf, key));
+	}
+	const_iterator upper_bound(const key_type& key) const {
+		if (!_root)
+			return end();
+		Leaf* leaf = findLeaf(key);
+		return position(leaf, upperIndex(leaf, key));
+	}
+
+	//observers
+	key_compare key_comp() const { return _comp; }
+	value_compare value_comp() const { return value_compare(_comp); }
+
+private:
+	// A position past the end of a leaf is the start of the next one
+	iterator position(Leaf* leaf, size_type idx) const
+	{
+		if (idx == leaf->count && leaf->next)
+			return iterator(leaf->next, 0);
+		return iterator(leaf, idx);
+	}
+
+	Leaf* findLeaf(const key_type& key) const
+	{
+		Node* node = _root;
+		while (!node->leaf)
+		{
+			Inner* inner = static_cast<Inner*>(node);
+			node = inner->children[childIndex(inner, key)];
+		}
+		return static_cast<Leaf*>(node);
+	}
+
+	// Number of keys not greater than key, which is the child to follow
+	size_type childIndex(Inner* inner, const key_type& key) const
+	{
+		const key_type* keys = inner->keys();
+		size_type lo = 0;
+		size_type hi = inner->count;
+		while (lo < hi)
+		{
+			const size_type mid = (lo + hi) / 2;
+			if (_comp(key, keys[mid]))
+				hi = mid;
+			else
+				lo = mid + 1;
+		}
+		return lo;
+	}
+	size_type lowerIndex(Leaf* leaf, const key_type& key) const
+	{
+		const value_type* values = leaf->values();
+		size_type lo = 0;
+		size_type hi = leaf->count;
+		while (lo < hi)
+		{
+			const size_type mid = (lo + hi) / 2;
+			if (_comp(values[mid].first, key))
+				lo = mid + 1;
+			else
+				hi = mid;
+		}
+		return lo;
+	}
+	size_type upperIndex(Leaf* leaf, const key_type& key) const
+	{
+		const value_type* values = leaf->values();
+		size_type lo = 0;
+		size_type hi = leaf->count;
+		while (lo < hi)
+		{
+			const size_type mid = (lo + hi) / 2;
+			if (_comp(key, values[mid].first))
+				hi = mid;
+			else
+				lo = mid + 1;
+		}
+		return lo;
+	}
+
+	// Finds where key is, or where it would be inserted. Keys are routed to
+	// a single leaf, so it is enough to look there.
+	bool findSlot(const key_type& key, Leaf*& leaf, size_type& idx) const
+	{
+		leaf = NULL;
+		idx = 0;
+		if (!_root)
+			return false;
+		leaf = findLeaf(key);
+		idx = lowerIndex(leaf, key);
+		return idx < leaf->count && !_comp(key, leaf->values()[idx].first);
+	}
+
+	// Builds value in a new slot at leaf[idx], which is dropped again when
+	// that throws. value must not be one of the elements, as opening the
+	// slot moves them.
+	void constructAt(Leaf*& leaf, size_type& idx, const value_type& value)
+	{
+		makeRoom(value.first, leaf, idx);
+		try
+		{
+			alloc_traits::construct(_alloc, leaf->values() + idx, value);
+		}
+		catch (...)
+		{
+			dropSlot(leaf, idx);
+			throw;
+		}
+	}
+#ifdef FT_CXX11
+	void constructAt(Leaf*& leaf, size_type& idx, value_type&& value)
+	{
+		makeRoom(value.first, leaf, idx);
+		try
+		{
+			alloc_traits::construct(_alloc, leaf->values() + idx, std::move(value));
+		}
+		catch (...)
+		{
+			dropSlot(leaf, idx);
+			throw;
+		}
+	}
+#endif
+
+	// Opens an unconstructed slot for key at leaf[idx], splitting nodes on
+	// the way up when they are full. leaf and idx are moved to the slot.
+	void makeRoom(const key_type& key, Leaf*& leaf, size_type& idx)
+	{
+		_size++;
+		if (!leaf)
+		{
+			leaf = newLeaf();
+			leaf->count = 1;
+			_root = leaf;
+			_first = leaf;
+			_last = leaf;
+			return;
+		}
+		if (leaf->count < leaf_slots)
+		{
+			relocateValues(leaf->values() + idx + 1, leaf->values() + idx, leaf->count - idx);
+			leaf->count++;
+			return;
+		}
+
+		// Appending to the last leaf leaves it full, so sorted input fills
+		// the leaves completely. Only the last leaf can then be under half
+		// full, which rebalancing copes with.
+		const size_type mid = (leaf == _last && idx == leaf->count) ? leaf_slots : (leaf_slots + 1) / 2;
+		Leaf* right = newLeaf();
+		right->prev = leaf;
+		right->next = leaf->next;
+		if (leaf->next)
+			leaf->next->prev = right;
+		else
+			_last = right;
+		leaf->next = right;
+
+		Leaf* slot = leaf;
+		if (idx < mid)
+		{
+			right->count = leaf->count - mid + 1;
+			relocateValues(right->values(), leaf->values() + mid - 1, right->count);
+			leaf->count = mid - 1;
+			relocateValues(leaf->values() + idx + 1, leaf->values() + idx, leaf->count - idx);
+			leaf->count++;
+		}
+		else
+		{
+			right->count = leaf->count - mid;
+			relocateValues(right->values(), leaf->values() + mid, right->count);
+			leaf->count = mid;
+			idx -= mid;
+			relocateValues(right->values() + idx + 1, right->values() + idx, right->count - idx);
+			right->count++;
+			slot = right;
+		}
+		insertChild(leaf, (slot == right && idx == 0) ? key : right->values()[0].first, right);
+		leaf = slot;
+	}
+
+	// Adds right after left in their parent, with key between them
+	void insertChild(Node* left, const key_type& key, Node* right)
+	{
+		Inner* parent = left->parent;
+
+		if (!parent)
+		{
+			parent = newInner();
+			setChild(parent, 0, left);
+			_root = parent;
+		}
+		const size_type pos = left->pos;
+		key_type* keys = parent->keys();
+		relocateKeys(keys + pos + 1, keys + pos, parent->count - pos);
+		for (size_type i = parent->count + 1; i > pos + 1; i--)
+			setChild(parent, i, parent->children[i - 1]);
+		key_traits::construct(_key_alloc, keys + pos, key);
+		setChild(parent, pos + 1, right);
+		parent->count++;
+		if (parent->count > inner_slots)
+			splitInner(parent);
+	}
+
+	// The middle key of an overfull node moves up, the keys after it go
+	// to a new sibling
+	void splitInner(Inner* node)
+	{
+		Inner* right = newInner();
+		const size_type mid = node->count / 2;
+
+		right->count = node->count - mid - 1;
+		relocateKeys(right->keys(), node->keys() + mid + 1, right->count);
+		for (size_type i = 0; i <= right->count; i++)
+			setChild(right, i, node->children[mid + 1 + i]);
+		node->count = mid;
+		insertChild(node, node->keys()[mid], right);
+		key_traits::destroy(_key_alloc, node->keys() + mid);
+	}
+
+	// Returns the element that followed the erased one
+	iterator eraseAt(Leaf* leaf, size_type idx)
+	{
+		alloc_traits::destroy(_alloc, leaf->values() + idx);
+		return dropSlot(leaf, idx);
+	}
+
+	// Closes the slot at leaf[idx], whose element is destroyed or was never
+	// built
+	iterator dropSlot(Leaf* leaf, size_type idx)
+	{
+		relocateValues(leaf->values() + idx, leaf->values() + idx + 1, leaf->count - idx - 1);
+		leaf->count--;
+		_size--;
+
+		if (leaf == _root && leaf->count == 0)
+		{
+			deleteLeaf(leaf);
+			_root = NULL;
+			_first = NULL;
+			_last = NULL;
+			return end();
+		}
+		if (leaf == _root || leaf->count >= min_leaf)
+			return position(leaf, idx);
+
+		// Rebalancing moves elements between leaves, so the next one is
+		// looked up again by key
+		iterator next = position(leaf, idx);
+		if (next == end())
+		{
+			rebalanceLeaf(leaf);
+			return end();
+		}
+		const key_type key = (*next).first;
+		rebalanceLeaf(leaf);
+		return lower_bound(key);
+	}
+
+	// Refills a leaf that fell under half full from a sibling, or merges it
+	// with one
+	void rebalanceLeaf(Leaf* leaf)
+	{
+		Inner* parent = leaf->parent;
+		const size_type pos = leaf->pos;
+		Leaf* left = pos > 0 ? static_cast<Leaf*>(parent->children[pos - 1]) : NULL;
+		Leaf* right = pos < parent->count ? static_cast<Leaf*>(parent->children[pos + 1]) : NULL;
+
+		if (left && left->count > min_leaf)
+		{
+			relocateValues(leaf->values() + 1, leaf->values(), leaf->count);
+			relocateValues(leaf->values(), left->values() + left->count - 1, 1);
+			left->count--;
+			leaf->count++;
+			setKey(parent, pos - 1, leaf->values()[0].first);
+		}
+		else if (right && right->count > min_leaf)
+		{
+			relocateValues(leaf->values() + leaf->count, right->values(), 1);
+			relocateValues(right->values(), right->values() + 1, right->count - 1);
+			right->count--;
+			leaf->count++;
+			setKey(parent, pos, right->values()[0].first);
+		}
+		else if (left)
+			mergeLeaves(left, leaf);
+		else
+			mergeLeaves(leaf, right);
+	}
+
+	void mergeLeaves(Leaf* left, Leaf* right)
+	{
+		Inner* parent = right->parent;
+		const size_type pos = right->pos;
+
+		relocateValues(left->values() + left->count, right->values(), right->count);
+		left->count += right->count;
+		left->next = right->next;
+		if (right->next)
+			right->next->prev = left;
+		else
+			_last = left;
+		deleteLeaf(right);
+		key_traits::destroy(_key_alloc, parent->keys() + pos - 1);
+		dropChild(parent, pos);
+	}
+
+	void rebalanceInner(Inner* node)
+	{
+		Inner* parent = node->parent;
+		const size_type pos = node->pos;
+		Inner* left = pos > 0 ? static_cast<Inner*>(parent->children[pos - 1]) : NULL;
+		Inner* right = pos < parent->count ? static_cast<Inner*>(parent->children[pos + 1]) : NULL;
+
+		// Borrowing goes through the parent: its key comes down and the
+		// sibling's outermost key takes its place
+		if (left && left->count > min_inner)
+		{
+			relocateKeys(node->keys() + 1, node->keys(), node->count);
+			for (size_type i = node->count + 1; i > 0; i--)
+				setChild(node, i, node->children[i - 1]);
+			relocateKeys(node->keys(), parent->keys() + pos - 1, 1);
+			setChild(node, 0, left->children[left->count]);
+			relocateKeys(parent->keys() + pos - 1, left->keys() + left->count - 1, 1);
+			left->count--;
+			node->count++;
+		}
+		else if (right && right->count > min_inner)
+		{
+			relocateKeys(node->keys() + node->count, parent->keys() + pos, 1);
+			setChild(node, node->count + 1, right->children[0]);
+			relocateKeys(parent->keys() + pos, right->keys(), 1);
+			relocateKeys(right->keys(), right->keys() + 1, right->count - 1);
+			for (size_type i = 0; i < right->count; i++)
+				setChild(right, i, right->children[i + 1]);
+			right->count--;
+			node->count++;
+		}
+		else if (left)
+			mergeInner(left, node);
+		else
+			mergeInner(node, right);
+	}
+
+	void mergeInner(Inner* left, Inner* right)
+	{
+		Inner* parent = right->parent;
+		const size_type pos = right->pos;
+
+		relocateKeys(left->keys() + left->count, parent->keys() + pos - 1, 1);
+		relocateKeys(left->keys() + left->count + 1, right->keys(), right->count);
+		for (size_type i = 0; i <= right->count; i++)
+			setChild(left, left->count + 1 + i, right->children[i]);
+		left->count += right->count + 1;
+		deleteInner(right);
+		dropChild(parent, pos);
+	}
+
+	// Removes child pos, the key before it must already be gone
+	void dropChild(Inner* node, size_type pos)
+	{
+		relocateKeys(node->keys() + pos - 1, node->keys() + pos, node->count - pos);
+		for (size_type i = pos; i < node->count; i++)
+			setChild(node, i, node->children[i + 1]);
+		node->count--;
+
+		if (node == _root)
+		{
+			if (node->count == 0)
+			{
+				_root = node->children[0];
+				_root->parent = NULL;
+				deleteInner(node);
+			}
+		}
+		else if (node->count < min_inner)
+			rebalanceInner(node);
+	}
+
+	void setChild(Inner* node, size_type i, Node* child)
+	{
+		node->children[i] = child;
+		child->parent = node;
+		child->pos = i;
+	}
+	void setKey(Inner* node, size_type i, const key_type& key)
+	{
+		key_traits::destroy(_key_alloc, node->keys() + i);
+		key_traits::construct(_key_alloc, node->keys() + i, key);
+	}
+
+	void relocateValues(value_type* dst, value_type* src, size_type n)
+	{
+		internal::relocate(_alloc, dst, src, n);
+	}
+	void relocateKeys(key_type* dst, key_type* src, size_type n)
+	{
+		internal::relocate(_key_alloc, dst, src, n);
+	}
+
+	Leaf* newLeaf()
+	{
+		Leaf* leaf = _leaf_alloc.allocate(1);
+		leaf->parent = NULL;
+		leaf->pos = 0;
+		leaf->count = 0;
+		leaf->leaf = true;
+		leaf->prev = NULL;
+		leaf->next = NULL;
+		return leaf;
+	}
+	Inner* newInner()
+	{
+		Inner* inner = _inner_alloc.allocate(1);
+		inner->parent = NULL;
+		inner->pos = 0;
+		inner->count = 0;
+		inner->leaf = false;
+		return inner;
+	}
+	void deleteLeaf(Leaf* leaf) { _leaf_alloc.deallocate(leaf, 1); }
+	void deleteInner(Inner* inner) { _inner_alloc.deallocate(inner, 1); }
+
+	void destroyTree(Node* node)
+	{
+		if (node->leaf)
+		{
+			Leaf* leaf = static_cast<Leaf*>(node);
+			for (size_type i = 0; i < leaf->count; i++)
+				alloc_traits::destroy(_alloc, leaf->values() + i);
+			deleteLeaf(leaf);
+			return;
+		}
+		Inner* inner = static_cast<Inner*>(node);
+		for (size_type i = 0; i < inner->count; i++)
+			key_traits::destroy(_key_alloc, inner->keys() + i);
+		for (size_type i = 0; i <= inner->count; i++)
+			destroyTree(inner->children[i]);
+		deleteInner(inner);
+	}
+
+private:
+	Node*			_root;
+	Leaf*			_first;
+	Leaf*			_last;
+	size_type		_size;
+	key_compare		_comp;
+	allocator_type	_alloc;
+	leaf_allocator	_leaf_alloc;
+	inner_allocator	_inner_alloc;
+	key_allocator	_key_alloc;
+};
+
+template< class Key, class T, class Compare, class Alloc, std::size_t N >
+bool operator==(const btree_map<Key, T, Compare, Alloc, N>& a, const btree_map<Key, T, Compare, Alloc, N>& b)
+{
+	if (a.size() != b.size())
+		return false;
+	return ft::equal(a.begin(), a.end(), b.begin());
+}
+
+template< class Key, class T, class Compare, class Alloc, std::size_t N >
+bool operator!=(const btree_map<Key, T, Compare, Alloc, N>& a, const btree_map<Key, T, Compare, Alloc, N>& b)
+{
+	return !(a == b);
+}
+
+template< class Key, class T, class Compare, class Alloc, std::size_t N >
+bool operator<(const btree_map<Key, T, Compare, Alloc, N>& a, const btree_map<Key, T, Compare, Alloc, N>& b)
+{
+	return ft::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end());
+}
+
+template< class Key, class T, class Compare, class Alloc, std::size_t N >
+bool operator>(const btree_map<Key, T, Compare, Alloc, N>& a, const btree_map<Key, T, Compare, Alloc, N>& b)
+{
+	return (b < a);
+}
+
+template< class Key, class T, class Compare, class Alloc, std::size_t N >
+bool operator<=(const btree_map<Key, T, Compare, Alloc, N>& a, const btree_map<Key, T, Compare, Alloc, N>& b)
+{
+	return !(a > b);
+}
+
+template< class Key, class T, class Compare, class Alloc, std::size_t N >
+bool operator>=(const btree_map<Key, T, Compare, Alloc, N>& a, const btree_map<Key, T, Compare, Alloc, N>& b)
+{
+	return !(a < b);
+}
+
+} //ft
+
+#endif // BTREE_MAP_HPP
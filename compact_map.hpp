@@ -0,0 +1,844 @@
+#ifndef COMPACT_MAP_HPP
+#define COMPACT_MAP_HPP
+
+#include <memory>
+#include <stdexcept>
+#include "iterator.hpp"
+#include "utils.hpp"
+#include "compare.hpp"
+#include "map.hpp"
+
+namespace ft
+{
+
+namespace internal
+{
+
+inline unsigned int highest_bit(unsigned int x)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	return 31 - __builtin_clz(x);
+#else
+	unsigned int i = 0;
+	while (x >>= 1)
+		i++;
+	return i;
+#endif
+}
+
+} //internal
+
+// AVL map with the interface of ft::map, for very large maps of small
+// elements. Nodes live in an arena of blocks growing geometrically and
+// link to each other by 32-bit index, with an 8-bit height: a node costs
+// 13 bytes next to its element, where an ft::map node costs 32 plus the
+// allocator's bookkeeping. Blocks never move, so inserting and erasing
+// keep iterators valid, but swapping the maps does not. Erased nodes are
+// reused by the next insertions, clear() gives the memory back.
+// Holds at most 2^32 - 2 elements.
+template <typename Key, typename T, typename Compare = ft::less<Key>,
+	typename Allocator = std::allocator<ft::pair<const Key, T> > >
+class compact_map
+{
+private:
+	struct Node;
+	struct Arena;
+	typedef internal::alloc_traits<Allocator>	alloc_traits;
+
+public:
+	typedef Allocator								allocator_type;
+	typedef typename alloc_traits::value_type		value_type;
+	typedef Compare									key_compare;
+	typedef map_value_compare<Key, T, key_compare>	value_compare;
+	typedef Key										key_type;
+	typedef T										data_type;
+	typedef T										mapped_type;
+	typedef typename alloc_traits::pointer			pointer;
+	typedef typename alloc_traits::const_pointer	const_pointer;
+	typedef typename alloc_traits::reference		reference;
+	typedef typename alloc_traits::const_reference	const_reference;
+	typedef typename alloc_traits::size_type		size_type;
+	typedef typename alloc_traits::difference_type	difference_type;
+	typedef typename alloc_traits::template rebind<Node>::other	node_allocator;
+	typedef unsigned int							index_type;
+
+	template<typename DataType>
+	class CompactIterator
+	{
+	public:
+		typedef DataType								value_type;
+		typedef DataType*								pointer;
+		typedef DataType&								reference;
+		typedef ft::bidirectional_iterator_tag			iterator_category;
+		typedef typename alloc_traits::difference_type	difference_type;
+
+		CompactIterator() :
+			_arena(NULL),
+			_idx(0)
+		{}
+		CompactIterator(const Arena* arena, index_type idx) :
+			_arena(arena),
+			_idx(idx)
+		{}
+		template<typename U>
+		CompactIterator(const CompactIterator<U>& other) :
+			_arena(other.arena()),
+			_idx(other.index())
+		{}
+
+		reference operator*() const { return _arena->at(_idx).value; }
+		pointer operator->() const { return &operator*(); }
+
+		CompactIterator& operator++() {
+			_idx = _arena->next(_idx);
+			return *this;
+		}
+		CompactIterator operator++(int)
+		{
+			CompactIterator tmp = *this;
+			++*this;
+			return tmp;
+		}
+
+		CompactIterator& operator--() {
+			_idx = _arena->prev(_idx);
+			return *this;
+		}
+		CompactIterator operator--(int)
+		{
+			CompactIterator tmp = *this;
+			--*this;
+			return tmp;
+		}
+
+		bool operator==(const CompactIterator& other) const { return _idx == other._idx; }
+		bool operator!=(const CompactIterator& other) const { return _idx != other._idx; }
+
+		const Arena* arena() const { return _arena; }
+		index_type index() const { return _idx; }
+
+	private:
+		const Arena*	_arena;
+		index_type		_idx;
+	};
+
+	typedef CompactIterator<value_type>					iterator;
+	typedef CompactIterator<const value_type>			const_iterator;
+	typedef ft::reverse_iterator<iterator>				reverse_iterator;
+	typedef ft::reverse_iterator<const_iterator>		const_reverse_iterator;
+
+private:
+	// Index 0 is no node: it stands for both a missing link and end().
+	// Only the links are set on free nodes, the value is constructed while
+	// the node is in the tree.
+	struct Node
+	{
+		index_type		parent;
+		index_type		left;
+		index_type		right;
+		unsigned char	height;
+		value_type		value;
+	};
+
+	// Block 0 holds the first 2^first_shift indices, block j > 0 the
+	// 2^(first_shift + j - 1) ones from 2^(first_shift + j - 1) on, so an
+	// index finds its block from its highest bit.
+	// Free nodes are chained through their right link.
+	struct Arena
+	{
+		enum
+		{
+			first_shift = 4,
+			block_count = 32 - first_shift + 1
+		};
+
+		static index_type blockOf(index_type i)
+		{
+			return (i >> first_shift) ? internal::highest_bit(i) - first_shift + 1 : 0;
+		}
+		static index_type blockSize(index_type block)
+		{
+			return index_type(1) << (block ? first_shift + block - 1 : index_type(first_shift));
+		}
+
+		Node& at(index_type i) const
+		{
+			if (!(i >> first_shift))
+				return blocks[0][i];
+			const unsigned int bit = internal::highest_bit(i);
+			return blocks[bit - first_shift + 1][i - (index_type(1) << bit)];
+		}
+
+		// The biggest node leads to 0, 0 stays put
+		index_type next(index_type i) const
+		{
+			if (!i)
+				return 0;
+			if (at(i).right)
+			{
+				i = at(i).right;
+				while (at(i).left)
+					i = at(i).left;
+				return i;
+			}
+			index_type up = at(i).parent;
+			while (up && i == at(up).right)
+			{
+				i = up;
+				up = at(up).parent;
+			}
+			return up;
+		}
+		// 0 leads to the biggest node
+		index_type prev(index_type i) const
+		{
+			if (!i)
+				return rightmost;
+			if (at(i).left)
+			{
+				i = at(i).left;
+				while (at(i).right)
+					i = at(i).right;
+				return i;
+			}
+			index_type up = at(i).parent;
+			while (up && i == at(up).left)
+			{
+				i = up;
+				up = at(up).parent;
+			}
+			return up;
+		}
+
+		Node*		blocks[block_count];
+		index_type	used;
+		index_type	free;
+		index_type	root;
+		index_type	leftmost;
+		index_type	rightmost;
+	};
+
+public:
+	//constructors
+	compact_map() :
+		_size(0),
+		_comp(Compare()),
+		_alloc(Allocator()),
+		_node_alloc(_alloc)
+	{
+		resetArena();
+	}
+	explicit compact_map(const key_compare& comp, const allocator_type& alloc = allocator_type()) :
+		_size(0),
+		_comp(comp),
+		_alloc(alloc),
+		_node_alloc(_alloc)
+	{
+		resetArena();
+	}
+	template <typename InputIt>
+	compact_map(InputIt first, InputIt last, const key_compare& comp = key_compare(),
+		const allocator_type& alloc = allocator_type(),
+	typename ft::enable_if<!ft::is_integral<InputIt>::value, InputIt>::type* = NULL) :
+		_size(0),
+		_comp(comp),
+		_alloc(alloc),
+		_node_alloc(_alloc)
+	{
+		resetArena();
+		insert(first, last);
+	}
+	compact_map(const compact_map& other) :
+		_size(0),
+		_comp(other._comp),
+		_alloc(other._alloc),
+		_node_alloc(other._node_alloc)
+	{
+		resetArena();
+		insert(other.begin(), other.end());
+	}
+	compact_map& operator=(const compact_map& other)
+	{
+		if (this == &other)
+			return *this;
+		clear();
+
+		_comp = other._comp;
+		_alloc = other._alloc;
+		_node_alloc = other._node_alloc;
+		insert(other.begin(), other.end());
+		return *this;
+	}
+
+#ifdef FT_CXX11
+	compact_map(compact_map&& other) :
+		_arena(other._arena),
+		_size(other._size),
+		_comp(std::move(other._comp)),
+		_alloc(other._alloc),
+		_node_alloc(other._node_alloc)
+	{
+		other.resetArena();
+		other._size = 0;
+	}
+	compact_map& operator=(compact_map&& other)
+	{
+		if (this == &other)
+			return *this;
+		clear();
+		swap(other);
+		return *this;
+	}
+#endif
+
+	~compact_map()
+	{
+		clear();
+	}
+
+	allocator_type get_allocator() const { return _alloc; }
+
+	//element access
+	T& at(const key_type& key)
+	{
+		iterator it = find(key);
+		if (it == end())
+			throw std::out_of_range("compact_map::at");
+		return (*it).second;
+	}
+	const T& at(const key_type& key) const
+	{
+		const_iterator it = find(key);
+		if (it == end())
+			throw std::out_of_range("compact_map::at");
+		return (*it).second;
+	}
+	T& operator[](const key_type& key)
+	{
+		index_type parent;
+		bool left;
+		index_type i = findPos(key, parent, left);
+		if (!i)
+			i = attach(createNode(value_type(key, data_type())), parent, left);
+		return node(i).value.second;
+	}
+
+	//iterators
+	iterator begin() { return iterator(&_arena, _arena.leftmost); }
+	const_iterator begin() const { return const_iterator(&_arena, _arena.leftmost); }
+	iterator end() { return iterator(&_arena, 0); }
+	const_iterator end() const { return const_iterator(&_arena, 0); }
+
+	reverse_iterator rbegin() { return reverse_iterator(end()); }
+	const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+	reverse_iterator rend() { return reverse_iterator(begin()); }
+	const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+	//capacity
+	bool empty() const { return _size == 0; }
+	size_type size() const { return _size; }
+	size_type max_size() const { return ft::min(size_type(index_type(-1) - 1), internal::alloc_traits<node_allocator>::max_size(_node_alloc)); }
+
+	//modifiers
+	void clear()
+	{
+		if (_arena.root)
+			destroyTree(_arena.root);
+		for (index_type b = 0; b < Arena::block_count && _arena.blocks[b]; b++)
+			_node_alloc.deallocate(_arena.blocks[b], Arena::blockSize(b));
+		resetArena();
+		_size = 0;
+	}
+
+	ft::pair<iterator,bool> insert(const value_type& value)
+	{
+		index_type parent;
+		bool left;
+		const index_type i = findPos(value.first, parent, left);
+		if (i)
+			return ft::make_pair(iterator(&_arena, i), false);
+		return ft::make_pair(iterator(&_arena, attach(createNode(value), parent, left)), true);
+	}
+	iterator insert(iterator position, const value_type& value)
+	{
+		index_type parent;
+		bool left;
+		const index_type i = findHintPos(position.index(), value.first, parent, left);
+		if (i)
+			return iterator(&_arena, i);
+		return iterator(&_arena, attach(createNode(value), parent, left));
+	}
+	template <typename InputIt>
+	void insert(InputIt first, InputIt last,
+	typename ft::enable_if<!ft::is_integral<InputIt>::value, InputIt>::type* = NULL)
+	{
+		for (; first != last; ++first)
+			insert(end(), *first);
+	}
+
+	void erase(iterator position)
+	{
+		if (position != end())
+			eraseNode(position.index());
+	}
+	void erase(iterator first, iterator last)
+	{
+		while (first != last)
+			erase(first++);
+	}
+	size_type erase(const key_type& key)
+	{
+		const index_type i = findNode(key);
+		if (!i)
+			return 0;
+		eraseNode(i);
+		return 1;
+	}
+
+	void swap(compact_map& other)
+	{
+		ft::swap(_arena, other._arena);
+		ft::swap(_size, other._size);
+		ft::swap(_comp, other._comp);
+		ft::swap(_alloc, other._alloc);
+		ft::swap(_node_alloc, other._node_alloc);
+	}
+
+	//lookup
+	size_type count(const key_type& key) const { return findNode(key) != 0; }
+	iterator find(const key_type& key) { return iterator(&_arena, findNode(key)); }
+	const_iterator find(const key_type& key) const { return const_iterator(&_arena, findNode(key)); }
+	ft::pair<iterator,iterator> equal_range(const key_type& key) {
+		return ft::make_pair(lower_bound(key), upper_bound(key));
+	}
+	ft::pair<const_iterator,const_iterator> equal_range(const key_type& key) const {
+		return ft::make_pair(lower_bound(key), upper_bound(key));
+	}
+
+	iterator lower_bound(const key_type& key) { return iterator(&_arena, lower(key)); }
+	const_iterator lower_bound(const key_type& key) const { return const_iterator(&_arena, lower(key)); }
+	iterator upper_bound(const key_type& key) { return iterator(&_arena, higher(key)); }
+	const_iterator upper_bound(const key_type& key) const { return const_iterator(&_arena, higher(key)); }
+
+	//observers
+	key_compare key_comp() const { return _comp; }
+	value_compare value_comp() const { return value_compare(_comp); }
+
+private:
+	Node& node(index_type i) const { return _arena.at(i); }
+	const key_type& key(index_type i) const { return node(i).value.first; }
+	unsigned char height(index_type i) const { return i ? node(i).height : 0; }
+
+	void resetArena()
+	{
+		for (index_type b = 0; b < Arena::block_count; b++)
+			_arena.blocks[b] = NULL;
+		_arena.used = 1;
+		_arena.free = 0;
+		_arena.root = 0;
+		_arena.leftmost = 0;
+		_arena.rightmost = 0;
+	}
+
+	// Takes a free node if there is one, else the next unused index
+	index_type newNode()
+	{
+		index_type i = _arena.free;
+
+		if (i)
+			_arena.free = node(i).right;
+		else
+		{
+			if (_arena.used == index_type(-1))
+				throw std::length_error("compact_map");
+			i = _arena.used++;
+			const index_type b = Arena::blockOf(i);
+			if (!_arena.blocks[b])
+				_arena.blocks[b] = _node_alloc.allocate(Arena::blockSize(b));
+		}
+		Node& n = node(i);
+		n.parent = 0;
+		n.left = 0;
+		n.right = 0;
+		n.height = 1;
+		return i;
+	}
+	index_type createNode(const value_type& value)
+	{
+		const index_type i = newNode();
+		try
+		{
+			alloc_traits::construct(_alloc, &node(i).value, value);
+		}
+		catch (...)
+		{
+			freeNode(i);
+			throw;
+		}
+		return i;
+	}
+	void freeNode(index_type i)
+	{
+		node(i).right = _arena.free;
+		_arena.free = i;
+	}
+	void destroyNode(index_type i)
+	{
+		alloc_traits::destroy(_alloc, &node(i).value);
+		freeNode(i);
+	}
+	void destroyTree(index_type i)
+	{
+		if (node(i).left)
+			destroyTree(node(i).left);
+		if (node(i).right)
+			destroyTree(node(i).right);
+		alloc_traits::destroy(_alloc, &node(i).value);
+	}
+
+	index_type findNode(const key_type& key) const
+	{
+		index_type i = _arena.root;
+		while (i)
+		{
+			if (_comp(key, this->key(i)))
+				i = node(i).left;
+			else if (_comp(this->key(i), key))
+				i = node(i).right;
+			else
+				return i;
+		}
+		return 0;
+	}
+
+	// Looks for key in a single descent. Returns its node, or 0 with
+	// parent and left telling where a node for it has to be attached.
+	index_type findPos(const key_type& key, index_type& parent, bool& left) const
+	{
+		index_type i = _arena.root;
+
+		parent = 0;
+		left = false;
+		while (i)
+		{
+			parent = i;
+			if (_comp(key, this->key(i)))
+			{
+				left = true;
+				i = node(i).left;
+			}
+			else if (_comp(this->key(i), key))
+			{
+				left = false;
+				i = node(i).right;
+			}
+			else
+				return i;
+		}
+		return 0;
+	}
+
+	// Same as findPos, but when key belongs right next to hint it is
+	// attached there without descending from the root.
+	index_type findHintPos(index_type hint, const key_type& key, index_type& parent, bool& left) const
+	{
+		if (!hint)
+		{
+			if (_size && _comp(this->key(_arena.rightmost), key))
+			{
+				parent = _arena.rightmost;
+				left = false;
+				return 0;
+			}
+		}
+		else if (_comp(key, this->key(hint)))
+		{
+			const index_type prev = (hint == _arena.leftmost) ? 0 : _arena.prev(hint);
+			if (!prev || _comp(this->key(prev), key))
+			{
+				left = !node(hint).left;
+				parent = left ? hint : prev;
+				return 0;
+			}
+		}
+		else if (_comp(this->key(hint), key))
+		{
+			const index_type next = _arena.next(hint);
+			if (!next || _comp(key, this->key(next)))
+			{
+				left = node(hint).right != 0;
+				parent = left ? next : hint;
+				return 0;
+			}
+		}
+		else
+			return hint;
+		return findPos(key, parent, left);
+	}
+
+	// Links a new node where findPos or findHintPos said it goes
+	index_type attach(index_type child, index_type parent, bool left)
+	{
+		node(child).parent = parent;
+		_size++;
+		if (!parent)
+		{
+			_arena.root = child;
+			_arena.leftmost = child;
+			_arena.rightmost = child;
+			return child;
+		}
+		if (left)
+		{
+			node(parent).left = child;
+			if (parent == _arena.leftmost)
+				_arena.leftmost = child;
+		}
+		else
+		{
+			node(parent).right = child;
+			if (parent == _arena.rightmost)
+				_arena.rightmost = child;
+		}
+		rebalanceInsert(parent);
+		return child;
+	}
+
+	void eraseNode(index_type i)
+	{
+		Node& n = node(i);
+
+		if (i == _arena.rightmost)
+			_arena.rightmost = (i == _arena.leftmost) ? 0 : _arena.prev(i);
+		if (i == _arena.leftmost)
+			_arena.leftmost = _arena.next(i);
+		index_type from = n.parent;
+		if (n.left && n.right)
+		{
+			index_type succ = n.right;
+			while (node(succ).left)
+				succ = node(succ).left;
+			Node& s = node(succ);
+
+			from = succ;
+			if (s.parent != i)
+			{
+				from = s.parent;
+				node(from).left = s.right;
+				if (s.right)
+					node(s.right).parent = from;
+				s.right = n.right;
+				node(s.right).parent = succ;
+			}
+			s.left = n.left;
+			node(s.left).parent = succ;
+			s.height = n.height;
+			replace(i, succ);
+		}
+		else
+			replace(i, n.left ? n.left : n.right);
+		rebalance(from);
+
+		_size--;
+		destroyNode(i);
+	}
+
+	void replace(index_type i, index_type by)
+	{
+		const index_type parent = node(i).parent;
+
+		if (by)
+			node(by).parent = parent;
+		replaceChild(parent, i, by);
+	}
+	void replaceChild(index_type parent, index_type old, index_type by)
+	{
+		if (!parent)
+			_arena.root = by;
+		else if (node(parent).left == old)
+			node(parent).left = by;
+		else
+			node(parent).right = by;
+	}
+
+	index_type lower(const key_type& key) const
+	{
+		index_type i = _arena.root;
+		index_type res = 0;
+
+		while (i)
+		{
+			if (_comp(key, this->key(i)))
+			{
+				res = i;
+				i = node(i).left;
+			}
+			else if (_comp(this->key(i), key))
+				i = node(i).right;
+			else
+				return i;
+		}
+		return res;
+	}
+	index_type higher(const key_type& key) const
+	{
+		index_type i = _arena.root;
+		index_type res = 0;
+
+		while (i)
+		{
+			if (_comp(key, this->key(i)))
+			{
+				res = i;
+				i = node(i).left;
+			}
+			else
+				i = node(i).right;
+		}
+		return res;
+	}
+
+	void updateHeight(index_type i)
+	{
+		Node& n = node(i);
+		n.height = ft::max(height(n.left), height(n.right)) + 1;
+	}
+	bool isImbalanced(index_type i) const
+	{
+		const int diff = int(height(node(i).left)) - int(height(node(i).right));
+		return diff > 1 || diff < -1;
+	}
+
+	void rebalance(index_type from)
+	{
+		for (; from; from = node(from).parent)
+		{
+			updateHeight(from);
+			if (isImbalanced(from))
+				from = rotate(from);
+		}
+	}
+
+	// After an insertion the walk up can stop as soon as a subtree keeps
+	// its height, and a rotation always restores the height it had before.
+	void rebalanceInsert(index_type from)
+	{
+		for (; from; from = node(from).parent)
+		{
+			const unsigned char h = node(from).height;
+			updateHeight(from);
+			if (isImbalanced(from))
+			{
+				rotate(from);
+				return;
+			}
+			if (node(from).height == h)
+				return;
+		}
+	}
+
+	index_type rotate(index_type from)
+	{
+		const Node& n = node(from);
+
+		if (height(n.right) > height(n.left))
+		{
+			const Node& r = node(n.right);
+			if (height(r.right) < height(r.left))
+				rotateRight(n.right);
+			return rotateLeft(from);
+		}
+		const Node& l = node(n.left);
+		if (height(l.right) > height(l.left))
+			rotateLeft(n.left);
+		return rotateRight(from);
+	}
+
+	index_type rotateLeft(index_type i)
+	{
+		Node& n = node(i);
+		const index_type top = n.right;
+		Node& t = node(top);
+		const index_type parent = n.parent;
+
+		n.right = t.left;
+		if (t.left)
+			node(t.left).parent = i;
+		t.parent = parent;
+		n.parent = top;
+		t.left = i;
+
+		updateHeight(i);
+		updateHeight(top);
+		replaceChild(parent, i, top);
+		return top;
+	}
+
+	index_type rotateRight(index_type i)
+	{
+		Node& n = node(i);
+		const index_type top = n.left;
+		Node& t = node(top);
+		const index_type parent = n.parent;
+
+		n.left = t.right;
+		if (t.right)
+			node(t.right).parent = i;
+		t.parent = parent;
+		n.parent = top;
+		t.right = i;
+
+		updateHeight(i);
+		updateHeight(top);
+		replaceChild(parent, i, top);
+		return top;
+	}
+
+	Arena			_arena;
+	size_type		_size;
+	key_compare		_comp;
+	allocator_type	_alloc;
+	node_allocator	_node_alloc;
+};
+
+template< class Key, class T, class Compare, class Alloc >
+bool operator==(const compact_map<Key, T, Compare, Alloc>& a, const compact_map<Key, T, Compare, Alloc>& b)
+{
+	if (a.size() != b.size())
+		return false;
+	return ft::equal(a.begin(), a.end(), b.begin());
+}
+
+template< class Key, class T, class Compare, class Alloc >
+bool operator!=(const compact_map<Key, T, Compare, Alloc>& a, const compact_map<Key, T, Compare, Alloc>& b)
+{
+	return !(a == b);
+}
+
+template< class Key, class T, class Compare, class Alloc >
+bool operator<(const compact_map<Key, T, Compare, Alloc>& a, const compact_map<Key, T, Compare, Alloc>& b)
+{
+	return ft::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end());
+}
+
+template< class Key, class T, class Compare, class Alloc >
+bool operator>(const compact_map<Key, T, Compare, Alloc>& a, const compact_map<Key, T, Compare, Alloc>& b)
+{
+	return (b < a);
+}
+
+template< class Key, class T, class Compare, class Alloc >
+bool operator<=(const compact_map<Key, T, Compare, Alloc>& a, const compact_map<Key, T, Compare, Alloc>& b)
+{
+	return !(a > b);
+}
+
+template< class Key, class T, class Compare, class Alloc >
+bool operator>=(const compact_map<Key, T, Compare, Alloc>& a, const compact_map<Key, T, Compare, Alloc>& b)
+{
+	return !(a < b);
+}
+
+} //ft
+
+#endif // COMPACT_MAP_HPP
@@ -33,6 +33,14 @@ struct less
 	}
 };
 
+template<typename T>
+struct equal_to
+{
+	bool operator() (const T& x, const T& y) const {
+		return x == y;
+	}
+};
+
 //#include <functional>
 //std::less<int, double> a;
 
@@ -0,0 +1,635 @@
+#ifndef CONCURRENT_SKIPLIST_MAP_HPP
+#define CONCURRENT_SKIPLIST_MAP_HPP
+
+#include "utils.hpp"
+
+#ifdef FT_CXX11
+
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <new>
+#include <thread>
+#include <type_traits>
+#include <utility>
+#include "iterator.hpp"
+#include "compare.hpp"
+#include "map.hpp"
+
+namespace ft
+{
+
+namespace internal
+{
+
+// Epoch based reclamation. Threads pin the domain while they hold
+// pointers to shared nodes, and unlinked nodes are retired rather than
+// freed. The global epoch moves on once every pinned thread has seen it,
+// so a node retired in epoch e is unreachable from every pin once the
+// epoch reaches e + 2, and only then is it reclaimed.
+class epoch_domain
+{
+public:
+	typedef void (*reclaim_fn)(void* context, void* ptr);
+
+	// Per thread state, only its owner writes to it. Pins nest.
+	struct record
+	{
+		explicit record(epoch_domain& d) :
+			domain(d),
+			state(0),
+			owner(std::this_thread::get_id()),
+			nesting(0),
+			retires(0),
+			next(NULL)
+		{}
+
+		void pin()
+		{
+			if (nesting++)
+				return;
+			state.store(domain._epoch.load() << 1 | 1);
+		}
+		void unpin()
+		{
+			if (!--nesting)
+				state.store(state.load(std::memory_order_relaxed) & ~1UL, std::memory_order_release);
+		}
+
+		epoch_domain&							domain;
+		std::atomic<unsigned long>				state;	// epoch << 1, | 1 while pinned
+		std::thread::id							owner;
+		unsigned								nesting;
+		unsigned								retires;
+		std::deque<std::pair<void*, unsigned long> >	retired;
+		record*									next;
+	};
+
+	epoch_domain(reclaim_fn reclaim, void* context) :
+		_epoch(0),
+		_records(NULL),
+		_reclaim(reclaim),
+		_context(context),
+		_id(++counter())
+	{}
+	~epoch_domain()
+	{
+		reclaim_all();
+		record* r = _records.load();
+		while (r)
+		{
+			record* next = r->next;
+			delete r;
+			r = next;
+		}
+	}
+
+	epoch_domain(const epoch_domain&) = delete;
+	epoch_domain& operator=(const epoch_domain&) = delete;
+
+	// The record of the calling thread, created on its first call
+	record& local()
+	{
+		struct cache
+		{
+			unsigned long	id;
+			record*			r;
+		};
+		static thread_local cache last = { 0, NULL };
+
+		if (last.id == _id)
+			return *last.r;
+		const std::thread::id self = std::this_thread::get_id();
+		record* r = _records.load();
+		while (r && r->owner != self)
+			r = r->next;
+		if (!r)
+		{
+			r = new record(*this);
+			r->next = _records.load();
+			while (!_records.compare_exchange_weak(r->next, r))
+				;
+		}
+		last.id = _id;
+		last.r = r;
+		return *r;
+	}
+
+	// Called once ptr is unlinked, by a pinned thread
+	void retire(record& r, void* ptr)
+	{
+		r.retired.push_back(std::make_pair(ptr, _epoch.load()));
+		if (++r.retires < collect_interval)
+			return;
+		r.retires = 0;
+		tryAdvance();
+		const unsigned long epoch = _epoch.load();
+		while (!r.retired.empty() && r.retired.front().second + 2 <= epoch)
+		{
+			_reclaim(_context, r.retired.front().first);
+			r.retired.pop_front();
+		}
+	}
+
+	// Reclaims everything retired, only while no thread is pinned
+	void reclaim_all()
+	{
+		for (record* r = _records.load(); r; r = r->next)
+		{
+			for (std::size_t i = 0; i < r->retired.size(); i++)
+				_reclaim(_context, r->retired[i].first);
+			r->retired.clear();
+		}
+	}
+
+private:
+	enum { collect_interval = 64 };
+
+	static std::atomic<unsigned long>& counter()
+	{
+		static std::atomic<unsigned long> c(0);
+		return c;
+	}
+
+	void tryAdvance()
+	{
+		unsigned long epoch = _epoch.load();
+		for (record* r = _records.load(); r; r = r->next)
+		{
+			const unsigned long state = r->state.load();
+			if ((state & 1) && (state >> 1) != epoch)
+				return;
+		}
+		_epoch.compare_exchange_strong(epoch, epoch + 1);
+	}
+
+	std::atomic<unsigned long>	_epoch;
+	std::atomic<record*>		_records;
+	reclaim_fn					_reclaim;
+	void*						_context;
+	unsigned long				_id;
+};
+
+class epoch_guard
+{
+public:
+	explicit epoch_guard(epoch_domain& domain) : _record(domain.local()) { _record.pin(); }
+	~epoch_guard() { _record.unpin(); }
+
+	epoch_domain::record& record() const { return _record; }
+
+	epoch_guard(const epoch_guard&) = delete;
+	epoch_guard& operator=(const epoch_guard&) = delete;
+
+private:
+	epoch_domain::record& _record;
+};
+
+} //internal
+
+// Ordered map for concurrent readers and writers, with the lookup
+// interface of ft::map. It is a lock-free skip list: insert links a node
+// by CAS from the bottom level up, erase marks the links of the node from
+// the top level down and whoever meets a marked node unlinks it. Readers
+// never write and never wait. Erased nodes are freed through epochs, so
+// an element stays readable as long as an iterator or call still sees it.
+// Iterators pin the map for the thread that made them, and must be used
+// and destroyed on that thread. size() is exact only when quiescent.
+template <typename Key, typename T, typename Compare = ft::less<Key>,
+	typename Allocator = std::allocator<ft::pair<const Key, T> > >
+class concurrent_skiplist_map
+{
+private:
+	struct Node;
+	typedef std::atomic<std::uintptr_t>			link;
+	typedef internal::alloc_traits<Allocator>	alloc_traits;
+
+public:
+	typedef Allocator									allocator_type;
+	typedef typename alloc_traits::value_type			value_type;
+	typedef Compare										key_compare;
+	typedef map_value_compare<Key, T, key_compare>		value_compare;
+	typedef Key											key_type;
+	typedef T											data_type;
+	typedef T											mapped_type;
+	typedef typename alloc_traits::pointer				pointer;
+	typedef typename alloc_traits::const_pointer		const_pointer;
+	typedef typename alloc_traits::reference			reference;
+	typedef typename alloc_traits::const_reference		const_reference;
+	typedef typename alloc_traits::size_type			size_type;
+	typedef typename alloc_traits::difference_type		difference_type;
+
+	template<typename DataType>
+	class SkipListIterator
+	{
+	public:
+		typedef DataType								value_type;
+		typedef DataType*								pointer;
+		typedef DataType&								reference;
+		typedef ft::forward_iterator_tag				iterator_category;
+		typedef typename alloc_traits::difference_type	difference_type;
+
+		SkipListIterator() :
+			_node(NULL),
+			_record(NULL)
+		{}
+		SkipListIterator(Node* node, internal::epoch_domain::record* record) :
+			_node(node),
+			_record(record)
+		{
+			pin();
+		}
+		SkipListIterator(const SkipListIterator& other) :
+			_node(other._node),
+			_record(other._record)
+		{
+			pin();
+		}
+		template<typename U>
+		SkipListIterator(const SkipListIterator<U>& other) :
+			_node(other.node()),
+			_record(other.record())
+		{
+			pin();
+		}
+		~SkipListIterator() { unpin(); }
+
+		SkipListIterator& operator=(const SkipListIterator& other)
+		{
+			if (other._record)
+				other._record->pin();
+			unpin();
+			_node = other._node;
+			_record = other._record;
+			return *this;
+		}
+
+		reference operator*() const { return _node->value; }
+		pointer operator->() const { return &operator*(); }
+
+		SkipListIterator& operator++() {
+			_node = _node->successor();
+			return *this;
+		}
+		SkipListIterator operator++(int)
+		{
+			SkipListIterator tmp = *this;
+			++*this;
+			return tmp;
+		}
+
+		bool operator==(const SkipListIterator& other) const { return _node == other._node; }
+		bool operator!=(const SkipListIterator& other) const { return _node != other._node; }
+
+		Node* node() const { return _node; }
+		internal::epoch_domain::record* record() const { return _record; }
+
+	private:
+		void pin() { if (_record) _record->pin(); }
+		void unpin() { if (_record) _record->unpin(); }
+
+		Node*								_node;
+		internal::epoch_domain::record*		_record;
+	};
+
+	typedef SkipListIterator<value_type>		iterator;
+	typedef SkipListIterator<const value_type>	const_iterator;
+
+	explicit concurrent_skiplist_map(const key_compare& comp = key_compare(),
+									 const allocator_type& alloc = allocator_type()) :
+		_comp(comp),
+		_alloc(alloc),
+		_node_alloc(alloc),
+		_size(0),
+		_domain(&reclaimNode, this)
+	{
+		for (int i = 0; i < max_height; i++)
+			_head[i].store(0, std::memory_order_relaxed);
+	}
+	~concurrent_skiplist_map()
+	{
+		Node* node = Node::ptr(_head[0].load());
+		while (node)
+		{
+			Node* next = Node::ptr(node->next()[0].load());
+			destroyNode(node);
+			node = next;
+		}
+		_domain.reclaim_all();
+	}
+
+	concurrent_skiplist_map(const concurrent_skiplist_map&) = delete;
+	concurrent_skiplist_map& operator=(const concurrent_skiplist_map&) = delete;
+
+	key_compare key_comp() const { return _comp; }
+	value_compare value_comp() const { return value_compare(_comp); }
+	allocator_type get_allocator() const { return _alloc; }
+
+	iterator begin() { return makeIterator<iterator>(NULL); }
+	const_iterator begin() const { return makeIterator<const_iterator>(NULL); }
+	iterator end() { return iterator(); }
+	const_iterator end() const { return const_iterator(); }
+
+	bool empty() const { return begin() == end(); }
+	size_type size() const { return _size.load(std::memory_order_relaxed); }
+	size_type max_size() const { return internal::alloc_traits<node_allocator>::max_size(_node_alloc); }
+
+	ft::pair<iterator, bool> insert(const value_type& value)
+	{
+		internal::epoch_guard guard(_domain);
+		link* preds[max_height];
+		Node* succs[max_height];
+		Node* node = NULL;
+
+		for (;;)
+		{
+			if (findPosition(value.first, preds, succs))
+			{
+				if (node)
+					destroyNode(node);
+				return ft::make_pair(iterator(succs[0], &guard.record()), false);
+			}
+			if (!node)
+				node = createNode(value, randomHeight());
+			for (int i = 0; i < node->height; i++)
+				node->next()[i].store(address(succs[i]), std::memory_order_relaxed);
+			std::uintptr_t expected = address(succs[0]);
+			if (preds[0][0].compare_exchange_strong(expected, address(node)))
+				break;
+		}
+		_size.fetch_add(1, std::memory_order_relaxed);
+		linkLevels(node, preds, succs);
+		iterator res(node, &guard.record());
+		release(node, guard.record());
+		return ft::make_pair(res, true);
+	}
+
+	size_type erase(const key_type& key)
+	{
+		internal::epoch_guard guard(_domain);
+		link* preds[max_height];
+		Node* succs[max_height];
+
+		if (!findPosition(key, preds, succs))
+			return 0;
+		Node* node = succs[0];
+		for (int i = node->height - 1; i > 0; i--)
+		{
+			std::uintptr_t next = node->next()[i].load();
+			while (!Node::marked(next) && !node->next()[i].compare_exchange_weak(next, next | 1))
+				;
+		}
+		// Marking the bottom link erases, only one thread gets to do it
+		std::uintptr_t next = node->next()[0].load();
+		for (;;)
+		{
+			if (Node::marked(next))
+				return 0;
+			if (node->next()[0].compare_exchange_weak(next, next | 1))
+				break;
+		}
+		_size.fetch_sub(1, std::memory_order_relaxed);
+		release(node, guard.record());
+		return 1;
+	}
+
+	// Erases the elements one by one, concurrent inserts may stay
+	void clear()
+	{
+		for (iterator it = begin(); it != end(); ++it)
+			erase((*it).first);
+	}
+
+	size_type count(const key_type& key) const { return find(key) != end(); }
+
+	iterator find(const key_type& key) { return makeIterator<iterator>(&key, true); }
+	const_iterator find(const key_type& key) const { return makeIterator<const_iterator>(&key, true); }
+
+	iterator lower_bound(const key_type& key) { return makeIterator<iterator>(&key); }
+	const_iterator lower_bound(const key_type& key) const { return makeIterator<const_iterator>(&key); }
+
+private:
+	enum { max_height = 16 };
+
+	// Links to the next node in every level of the tower follow the node.
+	// The low bit of a link marks the node it leaves as erased in that
+	// level, and freezes the link.
+	struct Node
+	{
+		value_type			value;
+		std::atomic<bool>	released;
+		unsigned char		height;
+
+		static std::size_t towerOffset() { return (sizeof(Node) + alignof(link) - 1) / alignof(link) * alignof(link); }
+		static bool marked(std::uintptr_t l) { return l & 1; }
+		static Node* ptr(std::uintptr_t l) { return reinterpret_cast<Node*>(l & ~std::uintptr_t(1)); }
+
+		link* next() const
+		{
+			return reinterpret_cast<link*>(reinterpret_cast<char*>(const_cast<Node*>(this)) + towerOffset());
+		}
+		bool erased() const { return marked(next()[0].load()); }
+
+		// The first node from node on that is not erased
+		static Node* live(Node* node)
+		{
+			while (node && node->erased())
+				node = ptr(node->next()[0].load());
+			return node;
+		}
+		Node* successor() const { return live(ptr(next()[0].load())); }
+	};
+
+	typedef typename std::aligned_storage<sizeof(link),
+		(alignof(Node) > alignof(link) ? alignof(Node) : alignof(link))>::type	unit;
+	typedef typename alloc_traits::template rebind<unit>::other					node_allocator;
+
+	static std::uintptr_t address(Node* node) { return reinterpret_cast<std::uintptr_t>(node); }
+	static std::size_t unitsFor(int height)
+	{
+		return (Node::towerOffset() + height * sizeof(link) + sizeof(unit) - 1) / sizeof(unit);
+	}
+
+	static int randomHeight()
+	{
+		static thread_local unsigned int seed = 0;
+		if (!seed)
+			seed = static_cast<unsigned int>(reinterpret_cast<std::uintptr_t>(&seed) >> 4) | 1;
+		seed ^= seed << 13;
+		seed ^= seed >> 17;
+		seed ^= seed << 5;
+		unsigned int bits = seed;
+		int height = 1;
+		while (height < max_height && !(bits & 3))
+		{
+			height++;
+			bits >>= 2;
+		}
+		return height;
+	}
+
+	Node* createNode(const value_type& value, int height)
+	{
+		unit* mem = _node_alloc.allocate(unitsFor(height));
+		Node* node = reinterpret_cast<Node*>(mem);
+		try
+		{
+			alloc_traits::construct(_alloc, &node->value, value);
+		}
+		catch (...)
+		{
+			_node_alloc.deallocate(mem, unitsFor(height));
+			throw;
+		}
+		new (&node->released) std::atomic<bool>(false);
+		node->height = static_cast<unsigned char>(height);
+		for (int i = 0; i < height; i++)
+			new (node->next() + i) link(0);
+		return node;
+	}
+
+	void destroyNode(Node* node)
+	{
+		const int height = node->height;
+		alloc_traits::destroy(_alloc, &node->value);
+		_node_alloc.deallocate(reinterpret_cast<unit*>(node), unitsFor(height));
+	}
+
+	static void reclaimNode(void* map, void* node)
+	{
+		static_cast<concurrent_skiplist_map*>(map)->destroyNode(static_cast<Node*>(node));
+	}
+
+	// Fills preds with the towers of the last nodes before key and succs
+	// with the nodes after them, in every level, unlinking the erased
+	// nodes met on the way. Returns whether succs[0] holds key.
+	bool findPosition(const key_type& key, link** preds, Node** succs)
+	{
+		bool retry = true;
+		while (retry)
+		{
+			retry = false;
+			link* pred = _head;
+			for (int level = max_height - 1; level >= 0 && !retry; level--)
+			{
+				Node* curr = Node::ptr(pred[level].load());
+				while (curr)
+				{
+					const std::uintptr_t succ = curr->next()[level].load();
+					if (Node::marked(succ))
+					{
+						std::uintptr_t expected = address(curr);
+						if (!pred[level].compare_exchange_strong(expected, succ & ~std::uintptr_t(1)))
+						{
+							retry = true;
+							break;
+						}
+						curr = Node::ptr(succ);
+						continue;
+					}
+					if (!_comp(curr->value.first, key))
+						break;
+					pred = curr->next();
+					curr = Node::ptr(succ);
+				}
+				preds[level] = pred;
+				succs[level] = curr;
+			}
+		}
+		return succs[0] && !_comp(key, succs[0]->value.first);
+	}
+
+	// The first node not erased and not less than key, without writing,
+	// erased nodes are stepped over rather than unlinked
+	Node* search(const key_type& key) const
+	{
+		const link* pred = _head;
+		Node* curr = NULL;
+		for (int level = max_height - 1; level >= 0; level--)
+		{
+			curr = Node::ptr(pred[level].load());
+			while (curr)
+			{
+				const std::uintptr_t succ = curr->next()[level].load();
+				if (Node::marked(succ))
+				{
+					curr = Node::ptr(succ);
+					continue;
+				}
+				if (!_comp(curr->value.first, key))
+				{
+					// Not erased either, as erase marks the bottom link last
+					if (!_comp(key, curr->value.first))
+						return curr;
+					break;
+				}
+				pred = curr->next();
+				curr = Node::ptr(succ);
+			}
+		}
+		return curr;
+	}
+
+	// The first live node, or the one search(*key) finds, which must
+	// hold key when exact
+	template<typename It>
+	It makeIterator(const key_type* key, bool exact = false) const
+	{
+		internal::epoch_guard guard(_domain);
+		Node* node = key ? search(*key) : Node::live(Node::ptr(_head[0].load()));
+		if (!node || (exact && _comp(*key, node->value.first)))
+			return It();
+		return It(node, &guard.record());
+	}
+
+	// Links node in the levels above the bottom one, giving up once it
+	// is erased
+	void linkLevels(Node* node, link** preds, Node** succs)
+	{
+		for (int i = 1; i < node->height; i++)
+		{
+			for (;;)
+			{
+				std::uintptr_t next = node->next()[i].load();
+				if (Node::marked(next))
+					return;
+				if (Node::ptr(next) != succs[i]
+					&& !node->next()[i].compare_exchange_strong(next, address(succs[i])))
+					continue;
+				std::uintptr_t expected = address(succs[i]);
+				if (preds[i][i].compare_exchange_strong(expected, address(node)))
+					break;
+				findPosition(node->value.first, preds, succs);
+				if (succs[0] != node)
+					return;
+			}
+		}
+	}
+
+	// Called once by the inserter of node and once by its eraser, the
+	// second one unlinks it from every level and retires it
+	void release(Node* node, internal::epoch_domain::record& record)
+	{
+		if (!node->released.exchange(true))
+			return;
+		link* preds[max_height];
+		Node* succs[max_height];
+		findPosition(node->value.first, preds, succs);
+		_domain.retire(record, node);
+	}
+
+	key_compare						_comp;
+	allocator_type					_alloc;
+	node_allocator					_node_alloc;
+	std::atomic<size_type>			_size;
+	link							_head[max_height];
+	mutable internal::epoch_domain	_domain;
+};
+
+} //ft
+
+#endif
+
+#endif // CONCURRENT_SKIPLIST_MAP_HPP
@@ -0,0 +1,438 @@
+#ifndef COW_VECTOR_HPP
+#define COW_VECTOR_HPP
+
+#include <cstddef>
+#include <memory>
+#include <new>
+#include <stdexcept>
+#include "iterator.hpp"
+#include "utils.hpp"
+#include "compare.hpp"
+#include "growth.hpp"
+#include "vector.hpp"
+
+namespace ft
+{
+
+// Vector whose copies share one reference counted ft::vector, for large
+// vectors handed around by value and seldom changed. Copies cost O(1),
+// and the first change of a shared copy copies the elements.
+// Reading through a non-const vector counts as a change, as it hands out
+// references that could be written to: read through a const one. Once
+// such references are out the vector stops sharing, copies of it are
+// deep until clear(), assign or operator= drop its elements.
+// Copies sharing elements may be used from different threads.
+template<typename T, typename Allocator = std::allocator<T>, typename Growth = ft::growth_double>
+class cow_vector {
+private:
+	typedef internal::alloc_traits<Allocator>	alloc_traits;
+
+public:
+	typedef ft::vector<T, Allocator, Growth>		vector_type;
+	typedef T										value_type;
+	typedef Allocator								allocator_type;
+	typedef typename alloc_traits::reference		reference;
+	typedef typename alloc_traits::const_reference	const_reference;
+	typedef typename alloc_traits::pointer			pointer;
+	typedef typename alloc_traits::const_pointer	const_pointer;
+	typedef value_type*								iterator;
+	typedef const value_type*						const_iterator;
+	typedef ft::reverse_iterator<iterator>			reverse_iterator;
+	typedef ft::reverse_iterator<const_iterator>const_reverse_iterator;
+	typedef typename alloc_traits::size_type		size_type;
+	typedef typename alloc_traits::difference_type	difference_type;
+	typedef Growth									growth_policy;
+
+	cow_vector() :
+		_rep(NULL),
+		_alloc(Allocator()),
+		_rep_alloc(_alloc)
+	{
+	}
+	explicit cow_vector(const Allocator& alloc) :
+		_rep(NULL),
+		_alloc(alloc),
+		_rep_alloc(_alloc)
+	{
+	}
+	explicit cow_vector(size_type n) :
+		_rep(NULL),
+		_alloc(Allocator()),
+		_rep_alloc(_alloc)
+	{
+		if (n)
+			_rep = createRep(vector_type(n));
+	}
+	cow_vector(size_type n, const T& value, const Allocator& alloc = Allocator()) :
+		_rep(NULL),
+		_alloc(alloc),
+		_rep_alloc(_alloc)
+	{
+		if (n)
+			_rep = createRep(vector_type(n, value, alloc));
+	}
+	template<typename InputIt>
+	cow_vector(InputIt first, InputIt last, const Allocator& alloc = Allocator(),
+	typename ft::enable_if<!ft::is_integral<InputIt>::value, InputIt>::type* = NULL) :
+		_rep(NULL),
+		_alloc(alloc),
+		_rep_alloc(_alloc)
+	{
+		if (first != last)
+			_rep = createRep(vector_type(first, last, alloc));
+	}
+	// Copies the elements once, later copies share them
+	explicit cow_vector(const vector_type& other) :
+		_rep(NULL),
+		_alloc(other.get_allocator()),
+		_rep_alloc(_alloc)
+	{
+		if (!other.empty())
+			_rep = createRep(other);
+	}
+
+	// Shares the elements of other, O(1)
+	cow_vector(const cow_vector& other) :
+		_rep(NULL),
+		_alloc(other._alloc),
+		_rep_alloc(other._rep_alloc)
+	{
+		_rep = share(other);
+	}
+#ifdef FT_CXX11
+	cow_vector(cow_vector&& other) :
+		_rep(other._rep),
+		_alloc(other._alloc),
+		_rep_alloc(other._rep_alloc)
+	{
+		other._rep = NULL;
+	}
+#endif
+
+	~cow_vector()
+	{
+		release(_rep);
+	}
+
+	cow_vector& operator=(const cow_vector& other)
+	{
+		if (&other == this)
+			return *this;
+		release(_rep);
+		_rep = NULL;
+		_alloc = other._alloc;
+		_rep_alloc = other._rep_alloc;
+		_rep = share(other);
+		return *this;
+	}
+#ifdef FT_CXX11
+	cow_vector& operator=(cow_vector&& other)
+	{
+		if (&other == this)
+			return *this;
+		release(_rep);
+		_alloc = other._alloc;
+		_rep_alloc = other._rep_alloc;
+		_rep = other._rep;
+		other._rep = NULL;
+		return *this;
+	}
+#endif
+
+	void assign(size_type count, const T& value)
+	{
+		reset().assign(count, value);
+	}
+	template <typename InputIt>
+	void assign(InputIt first, InputIt end,
+	typename ft::enable_if<!ft::is_integral<InputIt>::value, InputIt>::type* = NULL)
+	{
+		reset().assign(first, end);
+	}
+
+	allocator_type get_allocator() const {
+		return _alloc;
+	}
+
+	// The elements, without copying them. Empty ones come from a shared
+	// empty vector, which needs a default constructible allocator.
+	const vector_type& get() const { return _rep ? _rep->vec : empty_vector(); }
+	// Whether other copies hold the same elements
+	bool shared() const { return _rep && internal::ref_count(_rep->refs) > 1; }
+
+	//Element access
+	reference at(size_type pos) { return leak().at(pos); }
+	const_reference at(size_type pos) const
+	{
+		if (!_rep)
+			throw std::out_of_range("vector::at");
+		return _rep->vec.at(pos);
+	}
+	reference operator[](size_type pos) { return leak()[pos]; }
+	const_reference operator[](size_type pos) const { return _rep->vec[pos]; }
+	reference front() { return leak().front(); }
+	const_reference front() const { return _rep->vec.front(); }
+	reference back() { return leak().back(); }
+	const_reference back() const { return _rep->vec.back(); }
+	T* data() { return leak().data(); }
+	const T* data() const { return _rep ? _rep->vec.data() : NULL; }
+
+	//Iterators
+	iterator begin() { return leak().begin(); }
+	iterator end() { return leak().end(); }
+	const_iterator begin() const { return _rep ? _rep->vec.begin() : NULL; }
+	const_iterator end() const { return _rep ? _rep->vec.end() : NULL; }
+
+	reverse_iterator rbegin() { return reverse_iterator(end()); }
+	reverse_iterator rend() { return reverse_iterator(begin()); }
+	const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+	const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+	//Capacity
+	bool empty() const { return size() == 0; }
+	size_type size() const { return _rep ? _rep->vec.size() : 0; }
+	size_type max_size() const { return alloc_traits::max_size(_alloc); }
+	void reserve(size_type new_cap)
+	{
+		if (new_cap > capacity())
+			own().reserve(new_cap);
+	}
+	size_type capacity() const { return _rep ? _rep->vec.capacity() : 0; }
+	void shrink_to_fit()
+	{
+		if (capacity() > size())
+			own().shrink_to_fit();
+	}
+
+	//Modifiers
+	void clear()
+	{
+		if (shared())
+		{
+			release(_rep);
+			_rep = NULL;
+		}
+		else if (_rep)
+			reset();
+	}
+
+	iterator insert(const_iterator pos, const T& value)
+	{
+		return insert(pos, 1, value);
+	}
+	iterator insert(const_iterator pos, size_type count, const T& value)
+	{
+		const size_type idx = pos - constBegin();
+		vector_type& vec = leak();
+		return vec.insert(vec.begin() + idx, count, value);
+	}
+#ifdef FT_CXX11
+	iterator insert(const_iterator pos, T&& value)
+	{
+		return emplace(pos, std::move(value));
+	}
+
+	template<typename... Args>
+	iterator emplace(const_iterator pos, Args&&... args)
+	{
+		const size_type idx = pos - constBegin();
+		vector_type& vec = leak();
+		return vec.emplace(vec.begin() + idx, std::forward<Args>(args)...);
+	}
+#endif
+
+	template<class InputIt>
+	iterator insert(const_iterator pos, InputIt first, InputIt last,
+	typename ft::enable_if<!ft::is_integral<InputIt>::value, InputIt>::type* = NULL)
+	{
+		const size_type idx = pos - constBegin();
+		vector_type& vec = leak();
+		return vec.insert(vec.begin() + idx, first, last);
+	}
+
+	// pos may come from before the elements were copied
+	iterator erase(const_iterator pos)
+	{
+		const size_type idx = pos - constBegin();
+		vector_type& vec = leak();
+		return vec.erase(vec.begin() + idx);
+	}
+	iterator erase(const_iterator first, const_iterator last)
+	{
+		const size_type idx = first - constBegin();
+		const size_type count = last - first;
+		vector_type& vec = leak();
+		return vec.erase(vec.begin() + idx, vec.begin() + idx + count);
+	}
+
+	void push_back(const T& value) { own().push_back(value); }
+#ifdef FT_CXX11
+	void push_back(T&& value) { own().push_back(std::move(value)); }
+
+	template<typename... Args>
+	reference emplace_back(Args&&... args)
+	{
+		return leak().emplace_back(std::forward<Args>(args)...);
+	}
+#endif
+
+	void pop_back() { own().pop_back(); }
+
+	void resize(size_type count, T value = T())
+	{
+		if (count != size())
+			own().resize(count, value);
+	}
+
+	void swap(cow_vector& other)
+	{
+		if (&other == this)
+			return;
+		ft::swap(_rep, other._rep);
+		ft::swap(_alloc, other._alloc);
+		ft::swap(_rep_alloc, other._rep_alloc);
+	}
+
+private:
+	// refs counts the cow_vectors holding the block, shareable drops once
+	// the only holder hands out references to the elements
+	struct Rep
+	{
+		explicit Rep(const vector_type& other) :
+			refs(1),
+			shareable(true),
+			vec(other)
+		{
+		}
+
+		std::size_t	refs;
+		bool		shareable;
+		vector_type	vec;
+	};
+	typedef typename alloc_traits::template rebind<Rep>::other	rep_allocator;
+
+	static const vector_type& empty_vector()
+	{
+		static const vector_type empty;
+		return empty;
+	}
+
+	Rep* createRep(const vector_type& other)
+	{
+		Rep* rep = _rep_alloc.allocate(1);
+		try
+		{
+			new (rep) Rep(other);
+		}
+		catch (...)
+		{
+			_rep_alloc.deallocate(rep, 1);
+			throw;
+		}
+		return rep;
+	}
+
+	void release(Rep* rep)
+	{
+		if (!rep || !internal::ref_release(rep->refs))
+			return;
+		rep->~Rep();
+		_rep_alloc.deallocate(rep, 1);
+	}
+
+	// The block for a copy of other, a new one when references to its
+	// elements are out. Needs the allocators of other.
+	Rep* share(const cow_vector& other)
+	{
+		if (!other._rep)
+			return NULL;
+		if (!other._rep->shareable)
+			return createRep(other._rep->vec);
+		internal::ref_acquire(other._rep->refs);
+		return other._rep;
+	}
+
+	// begin() without leaking the elements
+	const_iterator constBegin() const { return begin(); }
+
+	// The elements, copied first when shared
+	vector_type& own()
+	{
+		if (!_rep)
+			_rep = createRep(vector_type(_alloc));
+		else if (shared())
+		{
+			Rep* rep = createRep(_rep->vec);
+			release(_rep);
+			_rep = rep;
+		}
+		return _rep->vec;
+	}
+
+	// Same as own, for callers handing out references to the elements
+	vector_type& leak()
+	{
+		vector_type& vec = own();
+		_rep->shareable = false;
+		return vec;
+	}
+
+	// Empties the elements, which no reference points to afterwards.
+	// Shared ones are left to the other copies rather than copied.
+	vector_type& reset()
+	{
+		if (shared())
+		{
+			release(_rep);
+			_rep = NULL;
+		}
+		vector_type& vec = own();
+		vec.clear();
+		_rep->shareable = true;
+		return vec;
+	}
+
+	Rep*			_rep;
+	allocator_type	_alloc;
+	rep_allocator	_rep_alloc;
+};
+
+template<typename T, typename A, typename G>
+bool operator==(const cow_vector<T, A, G>& a, const cow_vector<T, A, G>& b)
+{
+	return a.size() == b.size() && ft::equal(a.begin(), a.end(), b.begin());
+}
+
+template<typename T, typename A, typename G>
+bool operator!=(const cow_vector<T, A, G>& a, const cow_vector<T, A, G>& b)
+{
+	return !(a == b);
+}
+
+template<typename T, typename A, typename G>
+bool operator<(const cow_vector<T, A, G>& a, const cow_vector<T, A, G>& b)
+{
+	return ft::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end());
+}
+
+template<typename T, typename A, typename G>
+bool operator>(const cow_vector<T, A, G>& a, const cow_vector<T, A, G>& b)
+{
+	return (b < a);
+}
+
+template<typename T, typename A, typename G>
+bool operator<=(const cow_vector<T, A, G>& a, const cow_vector<T, A, G>& b)
+{
+	return !(a > b);
+}
+
+template<typename T, typename A, typename G>
+bool operator>=(const cow_vector<T, A, G>& a, const cow_vector<T, A, G>& b)
+{
+	return !(a < b);
+}
+
+} //ft
+
+#endif // COW_VECTOR_HPP
@@ -0,0 +1,605 @@
+#ifndef FLAT_MAP_HPP
+#define FLAT_MAP_HPP
+
+#include <memory>
+#include <stdexcept>
+#include "iterator.hpp"
+#include "utils.hpp"
+#include "compare.hpp"
+#include "vector.hpp"
+
+namespace ft
+{
+
+namespace internal
+{
+
+// Stable merge sort of a vector, then drops every element equivalent to
+// the one before it, so the first occurrence of a key wins
+template<typename Vector, typename Compare>
+void sort_unique(Vector& v, Compare comp)
+{
+	typedef typename Vector::size_type size_type;
+	const size_type n = v.size();
+	Vector buf(v);
+	Vector* src = &v;
+	Vector* dst = &buf;
+
+	for (size_type width = 1; width < n; width *= 2)
+	{
+		for (size_type lo = 0; lo < n; lo += 2 * width)
+		{
+			const size_type mid = ft::min(lo + width, n);
+			const size_type hi = ft::min(lo + 2 * width, n);
+			size_type i = lo;
+			size_type j = mid;
+			size_type k = lo;
+			while (i < mid && j < hi)
+			{
+				if (comp((*src)[j], (*src)[i]))
+					(*dst)[k++] = FT_MOVE((*src)[j++]);
+				else
+					(*dst)[k++] = FT_MOVE((*src)[i++]);
+			}
+			while (i < mid)
+				(*dst)[k++] = FT_MOVE((*src)[i++]);
+			while (j < hi)
+				(*dst)[k++] = FT_MOVE((*src)[j++]);
+		}
+		ft::swap(src, dst);
+	}
+	if (src != &v)
+		v.swap(buf);
+
+	size_type kept = 0;
+	for (size_type i = 0; i < n; i++)
+	{
+		if (kept > 0 && !comp(v[kept - 1], v[i]))
+			continue;
+		if (kept != i)
+			v[kept] = FT_MOVE(v[i]);
+		kept++;
+	}
+	v.erase(v.begin() + kept, v.end());
+}
+
+// Element of a flat_map keeping keys and values in separate arrays:
+// a pair of references into both
+template<typename Key, typename Mapped>
+struct flat_split_reference
+{
+	flat_split_reference(const Key& k, Mapped& m) : first(k), second(m) {}
+
+	template<typename K, typename M>
+	operator ft::pair<K, M>() const { return ft::pair<K, M>(first, second); }
+
+	const Key&	first;
+	Mapped&		second;
+};
+
+template<typename Key, typename M1, typename M2>
+bool operator==(const flat_split_reference<Key, M1>& a, const flat_split_reference<Key, M2>& b)
+{
+	return a.first == b.first && a.second == b.second;
+}
+
+template<typename Key, typename M1, typename M2>
+bool operator<(const flat_split_reference<Key, M1>& a, const flat_split_reference<Key, M2>& b)
+{
+	return a.first < b.first || (!(b.first < a.first) && a.second < b.second);
+}
+
+// Iterator over a flat_map keeping keys and values in separate arrays.
+// It dereferences to a pair of references.
+template<typename Key, typename Mapped>
+class flat_split_iterator
+{
+public:
+	typedef ft::pair<Key, Mapped>					value_type;
+	typedef flat_split_reference<Key, Mapped>		reference;
+	typedef std::ptrdiff_t							difference_type;
+	typedef ft::random_access_iterator_tag			iterator_category;
+
+	class pointer
+	{
+	public:
+		pointer(const reference& ref) : _ref(ref) {}
+		const reference* operator->() const { return &_ref; }
+
+	private:
+		reference	_ref;
+	};
+
+	flat_split_iterator() :
+		_key(NULL),
+		_mapped(NULL)
+	{}
+	flat_split_iterator(const Key* key, Mapped* mapped) :
+		_key(key),
+		_mapped(mapped)
+	{}
+	template<typename U>
+	flat_split_iterator(const flat_split_iterator<Key, U>& other) :
+		_key(other.key()),
+		_mapped(other.mapped())
+	{}
+
+	reference operator*() const { return reference(*_key, *_mapped); }
+	pointer operator->() const { return pointer(operator*()); }
+	reference operator[](difference_type n) const { return reference(_key[n], _mapped[n]); }
+
+	flat_split_iterator& operator++() { ++_key; ++_mapped; return *this; }
+	flat_split_iterator operator++(int) { flat_split_iterator tmp = *this; ++*this; return tmp; }
+	flat_split_iterator& operator--() { --_key; --_mapped; return *this; }
+	flat_split_iterator operator--(int) { flat_split_iterator tmp = *this; --*this; return tmp; }
+
+	flat_split_iterator& operator+=(difference_type n) { _key += n; _mapped += n; return *this; }
+	flat_split_iterator& operator-=(difference_type n) { _key -= n; _mapped -= n; return *this; }
+	flat_split_iterator operator+(difference_type n) const { return flat_split_iterator(_key + n, _mapped + n); }
+	flat_split_iterator operator-(difference_type n) const { return flat_split_iterator(_key - n, _mapped - n); }
+	difference_type operator-(const flat_split_iterator& other) const { return _key - other._key; }
+
+	bool operator==(const flat_split_iterator& other) const { return _key == other._key; }
+	bool operator!=(const flat_split_iterator& other) const { return _key != other._key; }
+	bool operator<(const flat_split_iterator& other) const { return _key < other._key; }
+	bool operator>(const flat_split_iterator& other) const { return _key > other._key; }
+	bool operator<=(const flat_split_iterator& other) const { return _key <= other._key; }
+	bool operator>=(const flat_split_iterator& other) const { return _key >= other._key; }
+
+	const Key* key() const { return _key; }
+	Mapped* mapped() const { return _mapped; }
+
+private:
+	const Key*	_key;
+	Mapped*		_mapped;
+};
+
+// Elements of a flat_map, stored as pairs in a single vector
+template<typename Key, typename T, typename Allocator, bool Split>
+class flat_storage
+{
+public:
+	typedef ft::pair<Key, T>									value_type;
+	typedef value_type&											reference;
+	typedef const value_type&									const_reference;
+	typedef typename internal::alloc_traits<Allocator>::template rebind<value_type>::other	allocator_type;
+	typedef ft::vector<value_type, allocator_type>				vector_type;
+	typedef typename vector_type::iterator						iterator;
+	typedef typename vector_type::const_iterator				const_iterator;
+	typedef typename vector_type::size_type						size_type;
+
+	explicit flat_storage(const Allocator& alloc) : _values(allocator_type(alloc)) {}
+
+	iterator begin() { return _values.begin(); }
+	const_iterator begin() const { return _values.begin(); }
+	iterator end() { return _values.end(); }
+	const_iterator end() const { return _values.end(); }
+
+	size_type size() const { return _values.size(); }
+	size_type max_size() const { return _values.max_size(); }
+	size_type capacity() const { return _values.capacity(); }
+	void reserve(size_type n) { _values.reserve(n); }
+	void shrink_to_fit() { _values.shrink_to_fit(); }
+	void clear() { _values.clear(); }
+	void swap(flat_storage& other) { _values.swap(other._values); }
+	Allocator get_allocator() const { return Allocator(_values.get_allocator()); }
+
+	const Key& key(size_type i) const { return _values[i].first; }
+	T& mapped(size_type i) { return _values[i].second; }
+
+	void insert(size_type i, const value_type& value) { _values.insert(_values.begin() + i, value); }
+	void erase(size_type first, size_type last) { _values.erase(_values.begin() + first, _values.begin() + last); }
+	void push_back(const value_type& value) { _values.push_back(value); }
+	void append(const flat_storage& other, size_type i) { _values.push_back(other._values[i]); }
+
+private:
+	vector_type	_values;
+};
+
+// Keys and values in two vectors, so lookups only walk the keys
+template<typename Key, typename T, typename Allocator>
+class flat_storage<Key, T, Allocator, true>
+{
+public:
+	typedef ft::pair<Key, T>									value_type;
+	typedef flat_split_reference<Key, T>						reference;
+	typedef flat_split_reference<Key, const T>					const_reference;
+	typedef flat_split_iterator<Key, T>							iterator;
+	typedef flat_split_iterator<Key, const T>					const_iterator;
+	typedef typename internal::alloc_traits<Allocator>::template rebind<Key>::other	key_allocator;
+	typedef typename internal::alloc_traits<Allocator>::template rebind<T>::other	mapped_allocator;
+	typedef typename ft::vector<Key, key_allocator>::size_type	size_type;
+
+	explicit flat_storage(const Allocator& alloc) :
+		_keys(key_allocator(alloc)),
+		_mapped(mapped_allocator(alloc))
+	{}
+
+	iterator begin() { return iterator(_keys.begin(), _mapped.begin()); }
+	const_iterator begin() const { return const_iterator(_keys.begin(), _mapped.begin()); }
+	iterator end() { return iterator(_keys.end(), _mapped.end()); }
+	const_iterator end() const { return const_iterator(_keys.end(), _mapped.end()); }
+
+	size_type size() const { return _keys.size(); }
+	size_type max_size() const { return ft::min(_keys.max_size(), _mapped.max_size()); }
+	size_type capacity() const { return _keys.capacity(); }
+	void reserve(size_type n)
+	{
+		_keys.reserve(n);
+		_mapped.reserve(n);
+	}
+	void shrink_to_fit()
+	{
+		_keys.shrink_to_fit();
+		_mapped.shrink_to_fit();
+	}
+	void clear()
+	{
+		_keys.clear();
+		_mapped.clear();
+	}
+	void swap(flat_storage& other)
+	{
+		_keys.swap(other._keys);
+		_mapped.swap(other._mapped);
+	}
+	Allocator get_allocator() const { return Allocator(_keys.get_allocator()); }
+
+	const Key& key(size_type i) const { return _keys[i]; }
+	T& mapped(size_type i) { return _mapped[i]; }
+
+	void insert(size_type i, const value_type& value)
+	{
+		_keys.insert(_keys.begin() + i, value.first);
+		_mapped.insert(_mapped.begin() + i, value.second);
+	}
+	void erase(size_type first, size_type last)
+	{
+		_keys.erase(_keys.begin() + first, _keys.begin() + last);
+		_mapped.erase(_mapped.begin() + first, _mapped.begin() + last);
+	}
+	void push_back(const value_type& value)
+	{
+		_keys.push_back(value.first);
+		_mapped.push_back(value.second);
+	}
+	void append(const flat_storage& other, size_type i)
+	{
+		_keys.push_back(other._keys[i]);
+		_mapped.push_back(other._mapped[i]);
+	}
+
+private:
+	ft::vector<Key, key_allocator>		_keys;
+	ft::vector<T, mapped_allocator>		_mapped;
+};
+
+} //internal
+
+// Associative container keeping its elements sorted in contiguous
+// storage. Lookups are binary searches, inserting or erasing one element
+// shifts the ones after it, so it suits tables built in batches and then
+// mostly read. With Split set, keys and values live in two separate
+// vectors and iterators dereference to pairs of references.
+// value_type is pair<Key, T>: keys are not const, as elements get moved
+// around, but must not be changed through iterators.
+template <typename Key, typename T, typename Compare = ft::less<Key>,
+	typename Allocator = std::allocator<ft::pair<Key, T> >, bool Split = false>
+class flat_map
+{
+private:
+	typedef internal::flat_storage<Key, T, Allocator, Split>	storage_type;
+
+public:
+	typedef Allocator										allocator_type;
+	typedef typename storage_type::value_type				value_type;
+	typedef Compare											key_compare;
+	typedef Key												key_type;
+	typedef T												data_type;
+	typedef T												mapped_type;
+	typedef typename storage_type::reference				reference;
+	typedef typename storage_type::const_reference			const_reference;
+	typedef typename storage_type::size_type				size_type;
+	typedef std::ptrdiff_t									difference_type;
+	typedef typename storage_type::iterator					iterator;
+	typedef typename storage_type::const_iterator			const_iterator;
+	typedef ft::reverse_iterator<iterator>					reverse_iterator;
+	typedef ft::reverse_iterator<const_iterator>			const_reverse_iterator;
+
+	class value_compare : public ft::binary_function<value_type, value_type, bool>
+	{
+	public:
+		value_compare(Compare c) : comp(c) {}
+
+		bool operator()(const value_type& lhs, const value_type& rhs) const {
+			return comp(lhs.first, rhs.first);
+		}
+
+	protected:
+		Compare comp;
+	};
+
+	//constructors
+	flat_map() :
+		_storage(Allocator()),
+		_comp(Compare())
+	{
+	}
+	explicit flat_map(const key_compare& comp, const allocator_type& alloc = allocator_type()) :
+		_storage(alloc),
+		_comp(comp)
+	{
+	}
+	template <typename InputIt>
+	flat_map(InputIt first, InputIt last, const key_compare& comp = key_compare(),
+		const allocator_type& alloc = allocator_type(),
+	typename ft::enable_if<!ft::is_integral<InputIt>::value, InputIt>::type* = NULL) :
+		_storage(alloc),
+		_comp(comp)
+	{
+		insert(first, last);
+	}
+	// [first, last) must be sorted and hold no duplicate keys
+	template <typename InputIt>
+	flat_map(from_sorted_t, InputIt first, InputIt last, const key_compare& comp = key_compare(),
+		const allocator_type& alloc = allocator_type()) :
+		_storage(alloc),
+		_comp(comp)
+	{
+		for (; first != last; ++first)
+			_storage.push_back(*first);
+	}
+
+	allocator_type get_allocator() const { return _storage.get_allocator(); }
+
+	//element access
+	T& at(const key_type& key)
+	{
+		const size_type i = lowerIndex(key);
+		if (!found(i, key))
+			throw std::out_of_range("flat_map::at");
+		return _storage.mapped(i);
+	}
+	const T& at(const key_type& key) const
+	{
+		return const_cast<flat_map*>(this)->at(key);
+	}
+	T& operator[](const key_type& key)
+	{
+		const size_type i = lowerIndex(key);
+		if (!found(i, key))
+			_storage.insert(i, value_type(key, mapped_type()));
+		return _storage.mapped(i);
+	}
+
+	//iterators
+	iterator begin() { return _storage.begin(); }
+	const_iterator begin() const { return _storage.begin(); }
+	iterator end() { return _storage.end(); }
+	const_iterator end() const { return _storage.end(); }
+
+	reverse_iterator rbegin() { return reverse_iterator(end()); }
+	const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+	reverse_iterator rend() { return reverse_iterator(begin()); }
+	const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+	//capacity
+	bool empty() const { return _storage.size() == 0; }
+	size_type size() const { return _storage.size(); }
+	size_type max_size() const { return _storage.max_size(); }
+	size_type capacity() const { return _storage.capacity(); }
+	void reserve(size_type n) { _storage.reserve(n); }
+	void shrink_to_fit() { _storage.shrink_to_fit(); }
+
+	//modifiers
+	void clear() { _storage.clear(); }
+
+	ft::pair<iterator,bool> insert(const value_type& value)
+	{
+		const size_type i = lowerIndex(value.first);
+		if (found(i, value.first))
+			return ft::make_pair(begin() + i, false);
+		_storage.insert(i, value);
+		return ft::make_pair(begin() + i, true);
+	}
+	// The hint is used when value belongs right before it
+	iterator insert(iterator position, const value_type& value)
+	{
+		const size_type i = position - begin();
+		if ((i == size() || _comp(value.first, _storage.key(i)))
+			&& (i == 0 || _comp(_storage.key(i - 1), value.first)))
+		{
+			_storage.insert(i, value);
+			return begin() + i;
+		}
+		return insert(value).first;
+	}
+	// The new elements are sorted on their own, then merged with the
+	// existing ones in a single pass. Existing keys are kept.
+	template <typename InputIt>
+	void insert(InputIt first, InputIt last,
+	typename ft::enable_if<!ft::is_integral<InputIt>::value, InputIt>::type* = NULL)
+	{
+		typedef typename internal::alloc_traits<Allocator>::template rebind<value_type>::other	value_allocator;
+
+		ft::vector<value_type, value_allocator> added((value_allocator(get_allocator())));
+		bool sorted = true;
+		for (; first != last; ++first)
+		{
+			added.push_back(*first);
+			if (added.size() > 1 && !_comp(added[added.size() - 2].first, added.back().first))
+				sorted = false;
+		}
+		if (!sorted)
+			internal::sort_unique(added, value_comp());
+		merge(added);
+	}
+
+	void erase(iterator position)
+	{
+		const size_type i = position - begin();
+		_storage.erase(i, i + 1);
+	}
+	void erase(iterator first, iterator last)
+	{
+		_storage.erase(first - begin(), last - begin());
+	}
+	size_type erase(const key_type& key)
+	{
+		const size_type i = lowerIndex(key);
+		if (!found(i, key))
+			return 0;
+		_storage.erase(i, i + 1);
+		return 1;
+	}
+
+	void swap(flat_map& other)
+	{
+		_storage.swap(other._storage);
+		ft::swap(_comp, other._comp);
+	}
+
+	//lookup
+	size_type count(const key_type& key) const { return found(lowerIndex(key), key); }
+	iterator find(const key_type& key)
+	{
+		const size_type i = lowerIndex(key);
+		return found(i, key) ? begin() + i : end();
+	}
+	const_iterator find(const key_type& key) const
+	{
+		const size_type i = lowerIndex(key);
+		return found(i, key) ? begin() + i : end();
+	}
+	ft::pair<iterator,iterator> equal_range(const key_type& key) {
+		return ft::make_pair(lower_bound(key), upper_bound(key));
+	}
+	ft::pair<const_iterator,const_iterator> equal_range(const key_type& key) const {
+		return ft::make_pair(lower_bound(key), upper_bound(key));
+	}
+
+	iterator lower_bound(const key_type& key) { return begin() + lowerIndex(key); }
+	const_iterator lower_bound(const key_type& key) const { return begin() + lowerIndex(key); }
+	iterator upper_bound(const key_type& key) { return begin() + upperIndex(key); }
+	const_iterator upper_bound(const key_type& key) const { return begin() + upperIndex(key); }
+
+	//observers
+	key_compare key_comp() const { return _comp; }
+	value_compare value_comp() const { return value_compare(_comp); }
+
+private:
+	size_type lowerIndex(const key_type& key) const
+	{
+		size_type lo = 0;
+		size_type hi = size();
+		while (lo < hi)
+		{
+			const size_type mid = (lo + hi) / 2;
+			if (_comp(_storage.key(mid), key))
+				lo = mid + 1;
+			else
+				hi = mid;
+		}
+		return lo;
+	}
+	size_type upperIndex(const key_type& key) const
+	{
+		size_type lo = 0;
+		size_type hi = size();
+		while (lo < hi)
+		{
+			const size_type mid = (lo + hi) / 2;
+			if (_comp(key, _storage.key(mid)))
+				hi = mid;
+			else
+				lo = mid + 1;
+		}
+		return lo;
+	}
+	bool found(size_type i, const key_type& key) const
+	{
+		return i < size() && !_comp(key, _storage.key(i));
+	}
+
+	// Merges sorted, unique elements into the map
+	template <typename Vector>
+	void merge(const Vector& added)
+	{
+		const size_type n = added.size();
+		if (n == 0)
+			return;
+		if (empty() || _comp(_storage.key(size() - 1), added[0].first))
+		{
+			_storage.reserve(size() + n);
+			for (size_type j = 0; j < n; j++)
+				_storage.push_back(added[j]);
+			return;
+		}
+
+		storage_type merged(get_allocator());
+		merged.reserve(size() + n);
+		size_type i = 0;
+		size_type j = 0;
+		while (i < size() && j < n)
+		{
+			if (_comp(added[j].first, _storage.key(i)))
+				merged.push_back(added[j++]);
+			else
+			{
+				if (!_comp(_storage.key(i), added[j].first))
+					j++;
+				merged.append(_storage, i++);
+			}
+		}
+		for (; i < size(); i++)
+			merged.append(_storage, i);
+		for (; j < n; j++)
+			merged.push_back(added[j]);
+		_storage.swap(merged);
+	}
+
+	storage_type	_storage;
+	key_compare		_comp;
+};
+
+template< class Key, class T, class Compare, class Alloc, bool Split >
+bool operator==(const flat_map<Key, T, Compare, Alloc, Split>& a, const flat_map<Key, T, Compare, Alloc, Split>& b)
+{
+	if (a.size() != b.size())
+		return false;
+	return ft::equal(a.begin(), a.end(), b.begin());
+}
+
+template< class Key, class T, class Compare, class Alloc, bool Split >
+bool operator!=(const flat_map<Key, T, Compare, Alloc, Split>& a, const flat_map<Key, T, Compare, Alloc, Split>& b)
+{
+	return !(a == b);
+}
+
+template< class Key, class T, class Compare, class Alloc, bool Split >
+bool operator<(const flat_map<Key, T, Compare, Alloc, Split>& a, const flat_map<Key, T, Compare, Alloc, Split>& b)
+{
+	return ft::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end());
+}
+
+template< class Key, class T, class Compare, class Alloc, bool Split >
+bool operator>(const flat_map<Key, T, Compare, Alloc, Split>& a, const flat_map<Key, T, Compare, Alloc, Split>& b)
+{
+	return (b < a);
+}
+
+template< class Key, class T, class Compare, class Alloc, bool Split >
+bool operator<=(const flat_map<Key, T, Compare, Alloc, Split>& a, const flat_map<Key, T, Compare, Alloc, Split>& b)
+{
+	return !(a > b);
+}
+
+template< class Key, class T, class Compare, class Alloc, bool Split >
+bool operator>=(const flat_map<Key, T, Compare, Alloc, Split>& a, const flat_map<Key, T, Compare, Alloc, Split>& b)
+{
+	return !(a < b);
+}
+
+} //ft
+
+#endif // FLAT_MAP_HPP
@@ -0,0 +1,273 @@
+#ifndef FLAT_SET_HPP
+#define FLAT_SET_HPP
+
+#include <memory>
+#include "iterator.hpp"
+#include "utils.hpp"
+#include "compare.hpp"
+#include "vector.hpp"
+#include "flat_map.hpp"
+
+namespace ft
+{
+
+// Sorted vector of unique keys, see flat_map
+template <typename Key, typename Compare = ft::less<Key>, typename Allocator = std::allocator<Key> >
+class flat_set
+{
+private:
+	typedef ft::vector<Key, Allocator>	vector_type;
+
+public:
+	typedef Key										key_type;
+	typedef Key										value_type;
+	typedef Compare									key_compare;
+	typedef Compare									value_compare;
+	typedef Allocator								allocator_type;
+	typedef const Key&								reference;
+	typedef const Key&								const_reference;
+	typedef typename vector_type::size_type			size_type;
+	typedef std::ptrdiff_t							difference_type;
+	typedef typename vector_type::const_iterator	iterator;
+	typedef typename vector_type::const_iterator	const_iterator;
+	typedef ft::reverse_iterator<iterator>			reverse_iterator;
+	typedef ft::reverse_iterator<const_iterator>	const_reverse_iterator;
+
+	//constructors
+	flat_set() :
+		_keys(Allocator()),
+		_comp(Compare())
+	{
+	}
+	explicit flat_set(const key_compare& comp, const allocator_type& alloc = allocator_type()) :
+		_keys(alloc),
+		_comp(comp)
+	{
+	}
+	template <typename InputIt>
+	flat_set(InputIt first, InputIt last, const key_compare& comp = key_compare(),
+		const allocator_type& alloc = allocator_type(),
+	typename ft::enable_if<!ft::is_integral<InputIt>::value, InputIt>::type* = NULL) :
+		_keys(alloc),
+		_comp(comp)
+	{
+		insert(first, last);
+	}
+	// [first, last) must be sorted and hold no duplicates
+	template <typename InputIt>
+	flat_set(from_sorted_t, InputIt first, InputIt last, const key_compare& comp = key_compare(),
+		const allocator_type& alloc = allocator_type()) :
+		_keys(first, last, alloc),
+		_comp(comp)
+	{
+	}
+
+	allocator_type get_allocator() const { return _keys.get_allocator(); }
+
+	//iterators
+	iterator begin() const { return _keys.begin(); }
+	iterator end() const { return _keys.end(); }
+	reverse_iterator rbegin() const { return reverse_iterator(end()); }
+	reverse_iterator rend() const { return reverse_iterator(begin()); }
+
+	//capacity
+	bool empty() const { return _keys.empty(); }
+	size_type size() const { return _keys.size(); }
+	size_type max_size() const { return _keys.max_size(); }
+	size_type capacity() const { return _keys.capacity(); }
+	void reserve(size_type n) { _keys.reserve(n); }
+	void shrink_to_fit() { _keys.shrink_to_fit(); }
+
+	//modifiers
+	void clear() { _keys.clear(); }
+
+	ft::pair<iterator,bool> insert(const value_type& value)
+	{
+		const size_type i = lowerIndex(value);
+		if (found(i, value))
+			return ft::make_pair(begin() + i, false);
+		_keys.insert(_keys.begin() + i, value);
+		return ft::make_pair(begin() + i, true);
+	}
+	// The hint is used when value belongs right before it
+	iterator insert(iterator position, const value_type& value)
+	{
+		const size_type i = position - begin();
+		if ((i == size() || _comp(value, _keys[i]))
+			&& (i == 0 || _comp(_keys[i - 1], value)))
+		{
+			_keys.insert(_keys.begin() + i, value);
+			return begin() + i;
+		}
+		return insert(value).first;
+	}
+	// The new keys are sorted on their own, then merged with the
+	// existing ones in a single pass
+	template <typename InputIt>
+	void insert(InputIt first, InputIt last,
+	typename ft::enable_if<!ft::is_integral<InputIt>::value, InputIt>::type* = NULL)
+	{
+		vector_type added(_keys.get_allocator());
+		bool sorted = true;
+		for (; first != last; ++first)
+		{
+			added.push_back(*first);
+			if (added.size() > 1 && !_comp(added[added.size() - 2], added.back()))
+				sorted = false;
+		}
+		if (!sorted)
+			internal::sort_unique(added, _comp);
+		merge(added);
+	}
+
+	void erase(iterator position)
+	{
+		_keys.erase(_keys.begin() + (position - begin()));
+	}
+	void erase(iterator first, iterator last)
+	{
+		_keys.erase(_keys.begin() + (first - begin()), _keys.begin() + (last - begin()));
+	}
+	size_type erase(const key_type& key)
+	{
+		const size_type i = lowerIndex(key);
+		if (!found(i, key))
+			return 0;
+		_keys.erase(_keys.begin() + i);
+		return 1;
+	}
+
+	void swap(flat_set& other)
+	{
+		_keys.swap(other._keys);
+		ft::swap(_comp, other._comp);
+	}
+
+	//lookup
+	size_type count(const key_type& key) const { return found(lowerIndex(key), key); }
+	iterator find(const key_type& key) const
+	{
+		const size_type i = lowerIndex(key);
+		return found(i, key) ? begin() + i : end();
+	}
+	ft::pair<iterator,iterator> equal_range(const key_type& key) const {
+		return ft::make_pair(lower_bound(key), upper_bound(key));
+	}
+	iterator lower_bound(const key_type& key) const { return begin() + lowerIndex(key); }
+	iterator upper_bound(const key_type& key) const { return begin() + upperIndex(key); }
+
+	//observers
+	key_compare key_comp() const { return _comp; }
+	value_compare value_comp() const { return _comp; }
+
+private:
+	size_type lowerIndex(const key_type& key) const
+	{
+		size_type lo = 0;
+		size_type hi = size();
+		while (lo < hi)
+		{
+			const size_type mid = (lo + hi) / 2;
+			if (_comp(_keys[mid], key))
+				lo = mid + 1;
+			else
+				hi = mid;
+		}
+		return lo;
+	}
+	size_type upperIndex(const key_type& key) const
+	{
+		size_type lo = 0;
+		size_type hi = size();
+		while (lo < hi)
+		{
+			const size_type mid = (lo + hi) / 2;
+			if (_comp(key, _keys[mid]))
+				hi = mid;
+			else
+				lo = mid + 1;
+		}
+		return lo;
+	}
+	bool found(size_type i, const key_type& key) const
+	{
+		return i < size() && !_comp(key, _keys[i]);
+	}
+
+	// Merges sorted, unique keys into the set
+	void merge(const vector_type& added)
+	{
+		const size_type n = added.size();
+		if (n == 0)
+			return;
+		if (empty() || _comp(_keys.back(), added[0]))
+		{
+			_keys.insert(_keys.end(), added.begin(), added.end());
+			return;
+		}
+
+		vector_type merged(_keys.get_allocator());
+		merged.reserve(size() + n);
+		size_type i = 0;
+		size_type j = 0;
+		while (i < size() && j < n)
+		{
+			if (_comp(added[j], _keys[i]))
+				merged.push_back(added[j++]);
+			else
+			{
+				if (!_comp(_keys[i], added[j]))
+					j++;
+				merged.push_back(_keys[i++]);
+			}
+		}
+		merged.insert(merged.end(), _keys.begin() + i, _keys.end());
+		merged.insert(merged.end(), added.begin() + j, added.end());
+		_keys.swap(merged);
+	}
+
+	vector_type		_keys;
+	key_compare		_comp;
+};
+
+template< class Key, class Compare, class Alloc >
+bool operator==(const flat_set<Key, Compare, Alloc>& a, const flat_set<Key, Compare, Alloc>& b)
+{
+	if (a.size() != b.size())
+		return false;
+	return ft::equal(a.begin(), a.end(), b.begin());
+}
+
+template< class Key, class Compare, class Alloc >
+bool operator!=(const flat_set<Key, Compare, Alloc>& a, const flat_set<Key, Compare, Alloc>& b)
+{
+	return !(a == b);
+}
+
+template< class Key, class Compare, class Alloc >
+bool operator<(const flat_set<Key, Compare, Alloc>& a, const flat_set<Key, Compare, Alloc>& b)
+{
+	return ft::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end());
+}
+
+template< class Key, class Compare, class Alloc >
+bool operator>(const flat_set<Key, Compare, Alloc>& a, const flat_set<Key, Compare, Alloc>& b)
+{
+	return (b < a);
+}
+
+template< class Key, class Compare, class Alloc >
+bool operator<=(const flat_set<Key, Compare, Alloc>& a, const flat_set<Key, Compare, Alloc>& b)
+{
+	return !(a > b);
+}
+
+template< class Key, class Compare, class Alloc >
+bool operator>=(const flat_set<Key, Compare, Alloc>& a, const flat_set<Key, Compare, Alloc>& b)
+{
+	return !(a < b);
+}
+
+} //ft
+
+#endif // FLAT_SET_HPP
@@ -0,0 +1,98 @@
+#ifndef GROWTH_HPP
+#define GROWTH_HPP
+
+#include <cstddef>
+#include "utils.hpp"
+
+namespace ft
+{
+
+// Growth policies decide how much a vector allocates when it runs out of
+// room and whether it gives memory back when it shrinks.
+//  grow(size, required, elem_size) returns the new capacity, never below
+//  required.
+//  shrink(size, capacity) returns the capacity to keep after an erase.
+
+struct growth_double
+{
+	template<typename Size>
+	static Size grow(Size size, Size required, Size elem_size)
+	{
+		(void)elem_size;
+		return ft::max(required, size * 2);
+	}
+	template<typename Size>
+	static Size shrink(Size size, Size capacity)
+	{
+		(void)size;
+		return capacity;
+	}
+};
+
+struct growth_half
+{
+	template<typename Size>
+	static Size grow(Size size, Size required, Size elem_size)
+	{
+		(void)elem_size;
+		return ft::max(required, size + size / 2);
+	}
+	template<typename Size>
+	static Size shrink(Size size, Size capacity)
+	{
+		(void)size;
+		return capacity;
+	}
+};
+
+// Grows by half and rounds the allocation up to the block the allocator
+// would hand out anyway: powers of two up to a page, whole pages above.
+struct growth_size_class
+{
+	static const std::size_t page_size = 4096;
+	static const std::size_t min_block = 16;
+
+	template<typename Size>
+	static Size grow(Size size, Size required, Size elem_size)
+	{
+		Size bytes = ft::max(required, size + size / 2) * elem_size;
+		Size block = min_block;
+
+		if (bytes > page_size)
+			block = (bytes + page_size - 1) / page_size * page_size;
+		else
+			while (block < bytes)
+				block *= 2;
+		return ft::max(required, block / elem_size);
+	}
+	template<typename Size>
+	static Size shrink(Size size, Size capacity)
+	{
+		(void)size;
+		return capacity;
+	}
+};
+
+// Wraps another policy and gives memory back once the vector drops below
+// a quarter of its capacity. It shrinks to twice the size, so a vector
+// hovering around a boundary does not reallocate on every operation.
+template<typename Growth = growth_double>
+struct shrink_on_erase
+{
+	template<typename Size>
+	static Size grow(Size size, Size required, Size elem_size)
+	{
+		return Growth::grow(size, required, elem_size);
+	}
+	template<typename Size>
+	static Size shrink(Size size, Size capacity)
+	{
+		if (size < capacity / 4)
+			return size * 2;
+		return capacity;
+	}
+};
+
+} //ft
+
+#endif // GROWTH_HPP
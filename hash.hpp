@@ -0,0 +1,70 @@
+#ifndef HASH_HPP
+#define HASH_HPP
+
+#include <cstddef>
+#include <string>
+
+namespace ft
+{
+
+// Hash functors for the unordered containers. Integers and pointers hash
+// to themselves, the containers mix the bits before using them.
+template<typename T> struct hash;
+
+#define FT_IDENTITY_HASH(T) \
+template<> struct hash<T> { \
+	std::size_t operator()(T value) const { return static_cast<std::size_t>(value); } \
+};
+
+FT_IDENTITY_HASH(bool)
+FT_IDENTITY_HASH(char)
+FT_IDENTITY_HASH(signed char)
+FT_IDENTITY_HASH(unsigned char)
+FT_IDENTITY_HASH(short)
+FT_IDENTITY_HASH(unsigned short)
+FT_IDENTITY_HASH(int)
+FT_IDENTITY_HASH(unsigned int)
+FT_IDENTITY_HASH(long)
+FT_IDENTITY_HASH(unsigned long)
+FT_IDENTITY_HASH(long long)
+FT_IDENTITY_HASH(unsigned long long)
+
+#undef FT_IDENTITY_HASH
+
+template<typename T>
+struct hash<T*>
+{
+	std::size_t operator()(T* value) const { return reinterpret_cast<std::size_t>(value); }
+};
+
+// FNV-1a
+template<>
+struct hash<std::string>
+{
+	std::size_t operator()(const std::string& value) const
+	{
+		unsigned long long h = 14695981039346656037ULL;
+		for (std::size_t i = 0; i < value.size(); i++)
+		{
+			h ^= static_cast<unsigned char>(value[i]);
+			h *= 1099511628211ULL;
+		}
+		return static_cast<std::size_t>(h);
+	}
+};
+
+namespace internal
+{
+
+// Spreads the bits of a hash, so identity hashes of integers are usable
+inline std::size_t mix_hash(std::size_t h)
+{
+	const unsigned long long x = static_cast<unsigned long long>(h) * 0x9e3779b97f4a7c15ULL;
+	return static_cast<std::size_t>(x ^ (x >> 32));
+}
+
+} //internal
+
+} //ft
+
+#endif // HASH_HPP
@@ -2,6 +2,7 @@
 #define ITERATOR_HPP
 
 #include <cstddef>
+#include <iterator>
 
 namespace ft
 {
@@ -31,22 +32,49 @@ struct iterator_traits<T*> {
 	typedef random_access_iterator_tag iterator_category;
 };
 
-template <class InputIt>
-typename iterator_traits<InputIt>::difference_type distance(InputIt first, InputIt last)
+namespace internal {
+
+// Maps both ft and std iterator tags onto the ft hierarchy, so iterators
+// coming from the standard library dispatch like our own.
+// Usage: to_ft_category(typename iterator_traits<It>::iterator_category())
+inline input_iterator_tag to_ft_category(input_iterator_tag) { return input_iterator_tag(); }
+inline forward_iterator_tag to_ft_category(forward_iterator_tag) { return forward_iterator_tag(); }
+inline bidirectional_iterator_tag to_ft_category(bidirectional_iterator_tag) { return bidirectional_iterator_tag(); }
+inline random_access_iterator_tag to_ft_category(random_access_iterator_tag) { return random_access_iterator_tag(); }
+inline input_iterator_tag to_ft_category(std::input_iterator_tag) { return input_iterator_tag(); }
+inline forward_iterator_tag to_ft_category(std::forward_iterator_tag) { return forward_iterator_tag(); }
+inline bidirectional_iterator_tag to_ft_category(std::bidirectional_iterator_tag) { return bidirectional_iterator_tag(); }
+inline random_access_iterator_tag to_ft_category(std::random_access_iterator_tag) { return random_access_iterator_tag(); }
+
+template <class InputIt1, class InputIt2>
+typename iterator_traits<InputIt1>::difference_type distance(InputIt1 first, InputIt2 last, input_iterator_tag)
 {
-	typename iterator_traits<InputIt>::difference_type n = 0;
+	typename iterator_traits<InputIt1>::difference_type n = 0;
 	for (; first != last; ++first)
 		++n;
 	return n;
 }
 
+template <class RandomIt1, class RandomIt2>
+typename iterator_traits<RandomIt1>::difference_type distance(RandomIt1 first, RandomIt2 last, random_access_iterator_tag)
+{
+	return last - first;
+}
+
+} //internal
+
+template <class InputIt>
+typename iterator_traits<InputIt>::difference_type distance(InputIt first, InputIt last)
+{
+	return internal::distance(first, last,
+		internal::to_ft_category(typename iterator_traits<InputIt>::iterator_category()));
+}
+
 template <class InputIt1, class InputIt2>
 typename iterator_traits<InputIt1>::difference_type distance(InputIt1 first, InputIt2 last)
 {
-	typename iterator_traits<InputIt1>::difference_type n = 0;
-	for (; first != last; ++first)
-		++n;
-	return n;
+	return internal::distance(first, last,
+		internal::to_ft_category(typename iterator_traits<InputIt1>::iterator_category()));
 }
 
 #define TRAIT iterator_traits<Iter>
@@ -71,7 +99,8 @@ public:
 		return *--tmp;
 	}
 	pointer operator->() const {
-		return &operator*();
+		Iter tmp = _base;
+		return to_pointer(--tmp);
 	}
 	reference operator[](difference_type n) const {
 		return *(*this + n);
@@ -112,6 +141,13 @@ public:
 	}
 
 private:
+	// Proxy iterators may return a temporary from operator*, so the
+	// address is taken through the base iterator instead
+	template <typename It>
+	static pointer to_pointer(const It& it) { return it.operator->(); }
+	template <typename T>
+	static pointer to_pointer(T* it) { return it; }
+
 	Iter _base;
 };
 
@@ -151,6 +187,18 @@ inline bool operator>=(const reverse_iterator<Iter>& x,
 	return x.base() <= y.base();
 }
 
+template <typename Iter>
+inline typename reverse_iterator<Iter>::difference_type operator-(const reverse_iterator<Iter>& x,
+																  const reverse_iterator<Iter>& y) {
+	return y.base() - x.base();
+}
+
+template <typename Iter>
+inline reverse_iterator<Iter> operator+(typename reverse_iterator<Iter>::difference_type n,
+										const reverse_iterator<Iter>& x) {
+	return x + n;
+}
+
 } //ft
 
 #endif // ITERATOR_HPP
@@ -1,8 +1,62 @@
 #include "vector.hpp"
+#include "small_vector.hpp"
+#include "cow_vector.hpp"
+#include "mmap_allocator.hpp"
+#include "pool_allocator.hpp"
+#include "arena.hpp"
 #include "map.hpp"
+#include "btree_map.hpp"
+#include "compact_map.hpp"
+#include "flat_map.hpp"
+#include "flat_set.hpp"
+#include "unordered_map.hpp"
+#include "sharded_map.hpp"
+#include "concurrent_skiplist_map.hpp"
+#include "persistent_map.hpp"
 #include <iostream>
+#include <stdexcept>
 
 #define ns ft
+#define GROWTH_VECTOR(T, G) ft::vector<T, std::allocator<T>, ft::G >
+#define SHRINK_TO_FIT(v) (v).shrink_to_fit()
+#define SMALL_VECTOR(T, N) ft::small_vector<T, N>
+#define COW_VECTOR(T) ft::cow_vector<T>
+#define COW_VECTOR_ALLOC(T, A) ft::cow_vector<T, A >
+#define MMAP_ALLOCATOR(T) ft::mmap_allocator<T>
+#define POOL_ALLOCATOR(T) ft::pool_allocator<T>
+#define ARENA(name) ft::arena name
+#define ARENA_ALLOCATOR(T) ft::arena_allocator<T>
+#define BTREE_MAP(K, V) ft::btree_map<K, V>
+#define COMPACT_MAP(K, V) ft::compact_map<K, V>
+#define FLAT_MAP(K, V) ft::flat_map<K, V>
+#define FLAT_MAP_SPLIT(K, V) ft::flat_map<K, V, ft::less<K>, std::allocator<ft::pair<K, V> >, true>
+#define FLAT_SET(K) ft::flat_set<K>
+#define UNORDERED_MAP(K, V) ft::unordered_map<K, V>
+#define SHARDED_MAP(K, V) ft::sharded_map<K, V>
+#define CONCURRENT_MAP(K, V) ft::concurrent_skiplist_map<K, V>
+#define PERSISTENT_MAP(K, V) ft::persistent_map<K, V>
+#define PERSISTENT_MAP_ALLOC(K, V, A) ft::persistent_map<K, V, ft::less<K>, A >
+#define SNAPSHOT(m) (m).snapshot()
+#define MAP_INSERT_OR_ASSIGN(m, key, value) (m).insert_or_assign(key, value).second
+#define MAP_CLEAR_KEEP(m) (m).clear(true)
+#define MAP_ALLOC(K, V, A) ft::map<K, V, ft::less<K>, A >
+#define MAP_THREADED(K, V) ft::map<K, V, ft::less<K>, std::allocator<ft::pair<const K, V> >, true>
+#define AUGMENTED_MAP(K, V) ft::map<K, V, ft::less<K>, std::allocator<ft::pair<const K, V> >, false, ft::mapped_sum<V> >
+#define MAP_NTH(m, k) (m).nth(k)
+#define MAP_RANK(m, key) (m).rank(key)
+#define MAP_COUNT_RANGE(m, lo, hi) (m).count_range(lo, hi)
+#define MAP_AGGREGATE(m, lo, hi) (m).aggregate(lo, hi)
+#define MAP_SPLIT(m, key, other) (m).split(key, other)
+#define MAP_JOIN(m, other) (m).join(other)
+#define MAP_UNION(a, b) ft::map_union(a, b)
+#define MAP_INTERSECTION(a, b) ft::map_intersection(a, b)
+#define MAP_DIFFERENCE(a, b) ft::map_difference(a, b)
+#define MAP_MERGE(m, other) (m).merge(other)
+#define THREAD_POOL(name, n) ft::thread_pool name(n)
+#define MAP_PARALLEL_BUILD(T, name, first, last, pool) T name(ft::from_sorted, first, last, pool)
+#define MAP_PARALLEL_COPY(T, name, other, pool) T name(other, pool)
+#define MAP_PARALLEL_FOR_EACH(m, fn, pool) ft::parallel_for_each(m, fn, pool)
+#define MAP_PARALLEL_CLEAR(m, pool) (m).clear(pool)
 
 template<typename T>
 void print_vector(const T& vec)
@@ -17,6 +71,24 @@ void print_vector(const T& vec)
 	std::cout << ']' << std::endl;
 }
 
+// Pushes n elements, printing the capacity each time it changes
+template<typename T>
+void print_growth(T& vec, int n)
+{
+	size_t cap = vec.capacity();
+	std::cout << cap;
+	for (int i = 0; i < n; i++)
+	{
+		vec.push_back(typename T::value_type());
+		if (vec.capacity() != cap)
+		{
+			cap = vec.capacity();
+			std::cout << ' ' << cap;
+		}
+	}
+	std::cout << std::endl;
+}
+
 void title(const std::string& text, int lvl = 2)
 {
 	for (int i = 0; i < lvl; i++)
@@ -325,9 +397,246 @@ void vector()
 		std::cout << (v < t) << std::endl;
 		t[1] = 15;
 		std::cout << (v < t) << std::endl;
+	} {
+		title("mmap allocator");
+		ns::vector<long, MMAP_ALLOCATOR(long) > v;
+		for (int i = 0; i < 5000; i++)
+			v.push_back(i);
+		v.erase(v.begin() + 10, v.end());
+		print_vector(v);
+		v.insert(v.begin() + 2, 3, v[5]);
+		v.insert(v.end(), v.begin(), v.begin() + 4);
+		print_vector(v);
+		ns::vector<std::string, MMAP_ALLOCATOR(std::string) > t(3, "abc");
+		t.push_back("de");
+		print_vector(t);
+	} {
+		title("shrink_to_fit");
+		ns::vector<int> v;
+		for (int i = 0; i < 100; i++)
+			v.push_back(i);
+		v.erase(v.begin() + 10, v.end());
+		print_vector(v);
+		SHRINK_TO_FIT(v);
+		print_vector(v);
+		v.clear();
+		SHRINK_TO_FIT(v);
+		print_vector(v);
+	} {
+		title("growth_double");
+		GROWTH_VECTOR(int, growth_double) d;
+		print_growth(d, 100);
+		title("growth_half");
+		GROWTH_VECTOR(int, growth_half) h;
+		print_growth(h, 100);
+		h.insert(h.begin(), 100, 1);
+		h.resize(500);
+		std::cout << h.size() << ' ' << h.capacity() << std::endl;
+		title("growth_size_class");
+		GROWTH_VECTOR(int, growth_size_class) s;
+		print_growth(s, 3000);
+		GROWTH_VECTOR(std::string, growth_size_class) ss;
+		print_growth(ss, 300);
+		SHRINK_TO_FIT(s);
+		s.push_back(1);
+		std::cout << s.size() << ' ' << s.capacity() << std::endl;
+
+		title("shrink_on_erase");
+		GROWTH_VECTOR(int, shrink_on_erase<>) e;
+		print_growth(e, 100);
+		e.erase(e.begin() + 20, e.end());
+		std::cout << e.size() << ' ' << e.capacity() << std::endl;
+		e.erase(e.begin());
+		std::cout << e.size() << ' ' << e.capacity() << std::endl;
+		size_t cap = e.capacity();
+		while (e.size() > 2)
+		{
+			e.pop_back();
+			if (e.capacity() != cap)
+			{
+				cap = e.capacity();
+				std::cout << e.size() << ':' << cap << ' ';
+			}
+		}
+		std::cout << std::endl;
+		e.resize(50, 5);
+		std::cout << e.size() << ' ' << e.capacity() << std::endl;
+		e.resize(3);
+		print_vector(e);
 	}
+#if __cplusplus >= 201103L
+	{
+		title("emplace");
+		ns::vector<std::string> v;
+		v.emplace_back(3, 'a');
+		v.emplace(v.begin(), "b");
+		v.push_back(std::string("c"));
+		v.insert(v.begin() + 1, std::string("d"));
+		print_vector(v);
+
+		title("emplace with mmap allocator");
+		ns::vector<long, MMAP_ALLOCATOR(long) > w;
+		w.emplace_back(1);
+		for (int i = 0; i < 5000; i++)
+			w.emplace_back(w[i / 2] + w.back());
+		for (int i = 0; i < 3000; i++)
+			w.emplace(w.begin() + i, w[w.size() - 1 - i] % 1000);
+		long n = 7;
+		w.insert(w.begin(), std::move(n));
+		w.push_back(std::move(w[3]));
+		long sum = 0;
+		for (size_t i = 0; i < w.size(); i++)
+			sum += w[i] % 1000003;
+		std::cout << w.size() << ' ' << sum << ' ' << w[0] << ' ' << w.back() << std::endl;
+
+		title("move constructor");
+		ns::vector<std::string> t(std::move(v));
+		print_vector(v);
+		print_vector(t);
+
+		title("move assignment");
+		v = std::move(t);
+		print_vector(v);
+		print_vector(t);
+	}
+#endif
 }
 
+template<typename T>
+void print_small_vector(const T& vec)
+{
+	std::cout << vec.size() << std::endl;
+	std::cout << '[';
+	typename T::const_iterator it = vec.begin();
+	if (it != vec.end())
+		std::cout << *(it++);
+	for (; it != vec.end(); ++it)
+		std::cout << ',' << *it;
+	std::cout << ']' << std::endl;
+}
+
+void small_vector()
+{
+	title("small_vector", 1);
+	{
+		title("push back inline");
+		SMALL_VECTOR(std::string, 4) v;
+		v.push_back("a");
+		v.push_back("b");
+		v.push_back("c");
+		print_small_vector(v);
+
+		title("push back past inline capacity");
+		for (int i = 0; i < 5; i++)
+			v.push_back(std::string(i + 1, 'x'));
+		print_small_vector(v);
+
+		title("insert and erase");
+		v.insert(v.begin() + 1, "d");
+		v.insert(v.begin(), 2, "e");
+		v.erase(v.begin() + 3, v.begin() + 6);
+		v.erase(v.end() - 1);
+		print_small_vector(v);
+
+		title("copy and swap");
+		SMALL_VECTOR(std::string, 4) t(v.begin(), v.begin() + 2);
+		SMALL_VECTOR(std::string, 4) u(v);
+		t.swap(u);
+		print_small_vector(t);
+		print_small_vector(u);
+
+		title("compare");
+		std::cout << (t == v) << ' ' << (u < v) << ' ' << (u == v) << std::endl;
+
+		title("resize and clear");
+		t.resize(2);
+		print_small_vector(t);
+		t.clear();
+		print_small_vector(t);
+	}
+}
+
+void cow_vector()
+{
+	title("cow_vector", 1);
+	title("copy");
+	COW_VECTOR(std::string) a;
+	for (int i = 0; i < 6; i++)
+		a.push_back(std::string(i + 1, 'a' + i));
+	COW_VECTOR(std::string) b(a);
+	COW_VECTOR(std::string) c;
+	c = b;
+	const COW_VECTOR(std::string)& cb = b;
+	std::cout << cb[2] << ' ' << cb.front() << ' ' << cb.back() << ' ' << cb.at(1) << ' ' << (a == c) << std::endl;
+
+	title("write after copy");
+	b[0] = "z";
+	c.push_back("g");
+	a.erase(a.begin() + 1, a.begin() + 3);
+	print_small_vector(a);
+	print_small_vector(b);
+	print_small_vector(c);
+
+	title("copy after write");
+	COW_VECTOR(std::string) d(b);
+	b.back() = "y";
+	*(d.begin() + 1) = "x";
+	d.insert(d.begin(), 2, "w");
+	print_small_vector(b);
+	print_small_vector(d);
+
+	title("assign and clear");
+	COW_VECTOR(std::string) e(d);
+	e.assign(3, "v");
+	COW_VECTOR(std::string) f(e);
+	f.pop_back();
+	f.resize(4, "u");
+	d.clear();
+	print_small_vector(e);
+	print_small_vector(f);
+	print_small_vector(d);
+	std::cout << d.empty() << ' ' << c.size() << ' ' << (e < f) << ' ' << (f != e) << std::endl;
+
+	title("swap");
+	e.swap(c);
+	COW_VECTOR(std::string)::const_reverse_iterator rit = static_cast<const COW_VECTOR(std::string)&>(e).rbegin();
+	std::cout << *rit << ' ' << *++rit << ' ' << c.size() << std::endl;
+
+	title("stateful allocator");
+	COW_VECTOR_ALLOC(int, POOL_ALLOCATOR(int)) p;
+	p.push_back(1);
+	COW_VECTOR_ALLOC(int, POOL_ALLOCATOR(int)) q(p);
+	{
+		COW_VECTOR_ALLOC(int, POOL_ALLOCATOR(int)) r(3, 7);
+		q = r;
+		p = r;
+		r.push_back(8);
+	}
+	q.push_back(2);
+	print_small_vector(p);
+	print_small_vector(q);
+	p = q;
+	q.clear();
+	print_small_vector(p);
+
+	title("allocator without default constructor");
+	ARENA(scratch);
+	typedef ARENA_ALLOCATOR(int) arena_int;
+	COW_VECTOR_ALLOC(int, arena_int) s((arena_int(scratch)));
+	const COW_VECTOR_ALLOC(int, arena_int)& cs = s;
+	std::cout << s.empty() << ' ' << s.size() << ' ' << cs.capacity() << ' ' << (cs.begin() == cs.end()) << std::endl;
+	s.assign(4, 2);
+	COW_VECTOR_ALLOC(int, arena_int) t(s);
+	std::cout << (s == t) << ' ' << (s < t) << std::endl;
+
+	title("assign to a shared copy");
+	t.assign(2, 5);
+	print_small_vector(s);
+	print_small_vector(t);
+	std::cout << (s == t) << ' ' << (s < t) << ' ' << cs.at(3) << std::endl;
+}
+
+
 template<typename T>
 void print_map(const T& map)
 {
@@ -344,6 +653,21 @@ void print_map(const T& map)
 	std::cout << ']' << std::endl;
 }
 
+template<typename T>
+void print_both_ways(const T& map)
+{
+	std::cout << map.size() << " [";
+	for (typename T::const_iterator it = map.begin(); it != map.end(); ++it)
+		std::cout << (*it).first << ':' << (*it).second << ' ';
+	std::cout << "] [";
+	for (typename T::const_iterator it = map.end(); it != map.begin();)
+	{
+		--it;
+		std::cout << (*it).first << ' ';
+	}
+	std::cout << ']' << std::endl;
+}
+
 void map()
 {
 	title("map", 1);
@@ -451,10 +775,18 @@ void map()
 	} {
 		title("insert position");
 		ns::map<int, int> m;
-		m.insert(ns::make_pair(0, 1));
+		m.insert(m.end(), ns::make_pair(0, 1));
 		print_map(m);
-		m.insert(ns::make_pair(1, 1));
+		m.insert(m.end(), ns::make_pair(1, 1));
+		print_map(m);
+		for (int i = 2; i < 8; i++)
+			m.insert(m.end(), ns::make_pair(i * 2, i));
+		m.insert(m.begin(), ns::make_pair(-1, 1));
+		std::cout << (*m.insert(m.find(6), ns::make_pair(5, 5))).first << std::endl;
+		std::cout << (*m.insert(m.begin(), ns::make_pair(7, 7))).first << std::endl;
+		std::cout << (*m.insert(m.end(), ns::make_pair(4, 9))).second << std::endl;
 		print_map(m);
+		std::cout << (*--m.end()).first << std::endl;
 	} {
 		title("insert range");
 		ns::vector<ns::pair<const std::string, int> > v;
@@ -478,6 +810,131 @@ void map()
 		title("erase range");
 		m.erase(m.begin(), m.end());
 		print_map(m);
+	} {
+		title("sorted range");
+		ns::vector<ns::pair<int, int> > v;
+		for (int i = 0; i < 20; i++)
+			v.push_back(ns::make_pair(i, i * i));
+		v.push_back(ns::make_pair(7, 0));
+		v.push_back(ns::make_pair(-3, 0));
+		ns::map<int, int> m(v.begin(), v.end());
+		print_map(m);
+		ns::map<int, int> n(m);
+		n.erase(10);
+		print_map(n);
+		m = n;
+		print_map(m);
+	} {
+		title("order statistics");
+		AUGMENTED_MAP(int, long) m;
+		for (int i = 0; i < 1000; i++)
+			m.insert(ns::make_pair((i * 389) % 1000, long(i)));
+		for (int i = 0; i < 1000; i += 4)
+			m.erase(i);
+		m[2000] = 5;
+		std::cout << (*MAP_NTH(m, 0)).first << ' ' << (*MAP_NTH(m, 500)).first << ' '
+			<< (MAP_NTH(m, 751) == m.end()) << std::endl;
+		std::cout << MAP_RANK(m, 0) << ' ' << MAP_RANK(m, 501) << ' ' << MAP_RANK(m, 5000) << std::endl;
+		std::cout << MAP_COUNT_RANGE(m, 100, 200) << ' ' << MAP_COUNT_RANGE(m, 200, 100) << std::endl;
+		std::cout << MAP_AGGREGATE(m, 0, 5000) << ' ' << MAP_AGGREGATE(m, 250, 750) << std::endl;
+		AUGMENTED_MAP(int, long) n(m);
+		n.erase(n.find(1), n.find(999));
+		std::cout << n.size() << ' ' << MAP_AGGREGATE(n, -1, 3000) << ' ' << MAP_RANK(n, 2000) << std::endl;
+	} {
+		title("split and join");
+		ns::map<int, int> m;
+		for (int i = 0; i < 100; i++)
+			m.insert(ns::make_pair(i * 3, i));
+		m.erase(m.find(30), m.find(60));
+		m.erase(m.lower_bound(250), m.end());
+		m.erase(m.begin(), m.find(9));
+		std::cout << m.size() << ' ' << (*m.begin()).first << ' ' << (*m.rbegin()).first << std::endl;
+		ns::map<int, int> n;
+		n[-1] = -1;
+		MAP_SPLIT(m, 100, n);
+		std::cout << m.size() << ' ' << (*m.rbegin()).first << ' ' << n.size() << ' ' << (*n.begin()).first << std::endl;
+		MAP_SPLIT(n, 1000, m);
+		print_map(m);
+		std::cout << n.size() << std::endl;
+		MAP_SPLIT(n, 0, m);
+		std::cout << n.size() << ' ' << m.size() << std::endl;
+		n[500] = 1;
+		MAP_JOIN(m, n);
+		std::cout << m.size() << ' ' << n.size() << ' ' << (*m.rbegin()).first << std::endl;
+		long sum = 0;
+		for (ns::map<int, int>::iterator it = m.begin(); it != m.end(); ++it)
+			sum += (*it).first;
+		std::cout << sum << std::endl;
+		AUGMENTED_MAP(int, long) a;
+		AUGMENTED_MAP(int, long) b;
+		for (int i = 0; i < 500; i++)
+			a.insert(ns::make_pair(i, long(i)));
+		MAP_SPLIT(a, 200, b);
+		a.erase(a.find(50), a.find(150));
+		std::cout << a.size() << ' ' << MAP_AGGREGATE(a, 0, 500) << ' ' << MAP_RANK(b, 300) << std::endl;
+		MAP_JOIN(a, b);
+		std::cout << a.size() << ' ' << MAP_AGGREGATE(a, 100, 400) << ' ' << (*MAP_NTH(a, 300)).first << std::endl;
+	} {
+		title("set operations");
+		ns::map<int, int> a;
+		ns::map<int, int> b;
+		for (int i = 0; i < 30; i++)
+			a.insert(ns::make_pair(i * 2, i));
+		for (int i = 0; i < 20; i++)
+			b.insert(ns::make_pair(i * 3, -i));
+		print_map(MAP_UNION(a, b));
+		print_map(MAP_INTERSECTION(a, b));
+		print_map(MAP_DIFFERENCE(a, b));
+		print_map(MAP_DIFFERENCE(b, a));
+		const ns::map<int, int> none;
+		std::cout << MAP_UNION(a, none).size() << ' ' << MAP_INTERSECTION(none, b).size() << std::endl;
+
+		title("merge");
+		ns::map<int, int> c;
+		c[100] = 1;
+		c[4] = 1;
+		MAP_MERGE(a, c);
+		std::cout << a.size() << ' ' << c.size() << ' ' << (*c.begin()).first << ' ' << a[100] << std::endl;
+		MAP_MERGE(b, a);
+		print_map(a);
+		std::cout << b.size() << ' ' << (*b.begin()).second << ' ' << (*b.rbegin()).first << std::endl;
+		MAP_MERGE(c, b);
+		std::cout << c.size() << ' ' << b.size() << std::endl;
+
+		title("merge between allocators");
+		typedef ns::pair<const int, int> int_pair;
+		typedef MAP_ALLOC(int, int, POOL_ALLOCATOR(int_pair)) pool_map;
+		pool_map p;
+		p[1] = 1;
+		p[4] = 1;
+		pool_map* q = new pool_map;
+		for (int i = 0; i < 30; i++)
+			(*q)[i * 2] = i;
+		MAP_MERGE(p, *q);
+		std::cout << p.size() << ' ' << q->size() << std::endl;
+		delete q;
+		print_map(p);
+
+		title("split and join between allocators");
+		q = new pool_map;
+		MAP_SPLIT(p, 40, *q);
+		pool_map r;
+		MAP_SPLIT(*q, 50, r);
+		delete q;
+		print_map(r);
+		q = new pool_map;
+		(*q)[100] = 100;
+		MAP_JOIN(r, *q);
+		delete q;
+		MAP_SPLIT(p, 20, p);
+		MAP_JOIN(p, p);
+		std::cout << p.size() << ' ' << r.size() << ' ' << (*r.rbegin()).first << std::endl;
+		pool_map shared((ns::less<int>()), r.get_allocator());
+		shared[-1] = 0;
+		MAP_JOIN(shared, r);
+		MAP_SPLIT(shared, 55, r);
+		print_map(shared);
+		print_map(r);
 	} {
 		title("swap");
 		ns::map<int, int> m;
@@ -536,13 +993,686 @@ void map()
 			std::cout << (pair.first == o.lower_bound(0))
 					  << ' ' << (pair.second == o.upper_bound(0)) << std::endl;
 		}
+	} {
+		title("clear keeping nodes");
+		ns::map<int, std::string> m;
+		for (int i = 0; i < 50; i++)
+			m[i] = std::string(i % 7 + 1, 'a' + i % 26);
+		MAP_CLEAR_KEEP(m);
+		print_map(m);
+		for (int i = 0; i < 40; i += 2)
+			m.insert(ns::make_pair(i * 3, std::string(i % 5 + 1, 'z' - i % 26)));
+		m[1] = "one";
+		print_map(m);
+		MAP_CLEAR_KEEP(m);
+		MAP_CLEAR_KEEP(m);
+		m[2] = "two";
+		print_map(m);
+
+		title("assign reusing nodes");
+		for (int i = 0; i < 30; i++)
+			m[i * 5] = std::string(i % 4 + 1, 'm');
+		ns::map<int, std::string> small;
+		small[1] = "one";
+		small[3] = "three";
+		ns::map<int, std::string> big(m);
+		big = small;
+		print_map(big);
+		small = m;
+		print_map(small);
+		big[0] = "zero";
+		small = big;
+		big = m;
+		print_map(small);
+		std::cout << (big == m) << ' ' << big.size() << std::endl;
+
+		title("assign between allocators");
+		typedef ns::pair<const int, std::string> entry;
+		typedef MAP_ALLOC(int, std::string, POOL_ALLOCATOR(entry)) pool_map;
+		pool_map p;
+		for (int i = 0; i < 40; i++)
+			p[i] = std::string(i % 3 + 1, 'p');
+		{
+			pool_map q;
+			q[7] = "seven";
+			q[8] = "eight";
+			p = q;
+			q[9] = "nine";
+		}
+		p[10] = "ten";
+		print_map(p);
+		{
+			pool_map r(p);
+			for (int i = 0; i < 20; i++)
+				r[i * 2] = "r";
+			p = r;
+		}
+		print_map(p);
+
+		title("maps sharing a pool allocator");
+		pool_map* src = new pool_map((ns::less<int>()), p.get_allocator());
+		for (int i = 0; i < 50; i++)
+			(*src)[i * 3] = "s";
+		pool_map dst((ns::less<int>()), p.get_allocator());
+		dst[1] = "d";
+		MAP_MERGE(dst, *src);
+		std::cout << src->size() << ' ';
+		delete src;
+		std::cout << dst.size() << ' ' << (*dst.rbegin()).first << std::endl;
+		dst.clear();
+		print_map(p);
+	} {
+		title("threaded insert and erase");
+		typedef MAP_THREADED(int, int) threaded_map;
+		threaded_map m;
+		for (int i = 0; i < 60; i++)
+			m.insert(ns::make_pair((i * 37) % 60, i));
+		for (int i = 0; i < 60; i += 4)
+			m.erase(i);
+		m.erase(m.begin());
+		m.erase(--m.end());
+		m.erase(m.find(30), m.find(37));
+		print_both_ways(m);
+
+		title("threaded hinted insert");
+		threaded_map::iterator hint = m.find(20);
+		for (int i = 20; i < 40; i += 4)
+			hint = m.insert(hint, ns::make_pair(i, -i));
+		m.insert(m.begin(), ns::make_pair(0, 100));
+		m.insert(m.end(), ns::make_pair(59, 100));
+		m.insert(m.end(), ns::make_pair(70, 100));
+		m.insert(m.find(45), ns::make_pair(44, 100));
+		print_both_ways(m);
+
+		title("threaded copy and swap");
+		threaded_map n(m);
+		n.erase(n.begin(), n.find(50));
+		n[-5] = 5;
+		threaded_map o;
+		o = n;
+		o.erase(-5);
+		m.swap(n);
+		print_both_ways(m);
+		print_both_ways(n);
+		print_both_ways(o);
+		threaded_map::iterator it = o.end();
+		std::cout << (*--it).first << ' ' << (*--it).first << ' ' << (*++it).first << ' ' << (++it == o.end()) << std::endl;
+		o.clear();
+		print_both_ways(o);
 	}
+#if __cplusplus >= 201103L
+	{
+		title("emplace");
+		ns::map<std::string, int> m;
+		m.emplace("one", 1);
+		m.emplace(std::string("one"), 2);
+		m.insert(ns::make_pair(std::string("two"), 2));
+		m[std::string("three")] = 3;
+		print_map(m);
+
+		title("move constructor");
+		ns::map<std::string, int> n(std::move(m));
+		print_map(m);
+		print_map(n);
+
+		title("move assignment");
+		m = std::move(n);
+		print_map(m);
+		print_map(n);
+	}
+	{
+		title("parallel");
+		typedef ns::map<int, int> map_type;
+		THREAD_POOL(pool, 4);
+		ns::vector<ns::pair<int, int> > v;
+		for (int i = 0; i < 5000; i++)
+			v.push_back(ns::make_pair(i * 2, i));
+		MAP_PARALLEL_BUILD(map_type, m, v.begin(), v.end(), pool);
+		MAP_PARALLEL_COPY(map_type, n, m, pool);
+		MAP_PARALLEL_FOR_EACH(n, [](ns::pair<const int, int>& p) { p.second *= 3; }, pool);
+		long sum = 0;
+		for (map_type::iterator it = n.begin(); it != n.end(); ++it)
+			sum += (*it).second;
+		std::cout << m.size() << ' ' << n.size() << ' ' << sum << ' ' << (*m.rbegin()).first << std::endl;
+		std::cout << (*n.find(1000)).second << ' ' << (*m.find(1000)).second << std::endl;
+		MAP_PARALLEL_CLEAR(n, pool);
+		n[1] = 1;
+		print_map(n);
+	}
+#endif
+}
+
+// Copies of the poison value throw while armed
+struct fragile
+{
+	static const int poison = -1;
+	static bool armed;
+
+	fragile(int v = 0) : value(v) {}
+	fragile(const fragile& other) : value(other.value)
+	{
+		if (armed && value == poison)
+			throw std::runtime_error("fragile");
+	}
+	fragile& operator=(const fragile& other)
+	{
+		value = other.value;
+		return *this;
+	}
+
+	int value;
+};
+bool fragile::armed = false;
+
+void btree_map()
+{
+	title("btree_map", 1);
+	{
+		title("insert");
+		BTREE_MAP(int, int) m;
+		for (int i = 0; i < 2000; i++)
+			m.insert(ns::make_pair((i * 7919) % 2000, i));
+		std::cout << m.size() << ' ' << (*m.begin()).first << ' ' << (*m.rbegin()).first << std::endl;
+		std::cout << m.insert(ns::make_pair(5, 0)).second << ' ' << m[5] << std::endl;
+
+		title("lookup");
+		std::cout << m.count(1999) << ' ' << m.count(2000) << std::endl;
+		std::cout << (*m.find(1234)).second << ' ' << (m.find(-1) == m.end()) << std::endl;
+		std::cout << (*m.lower_bound(100)).first << ' ' << (*m.upper_bound(100)).first << std::endl;
+		std::cout << (m.equal_range(2500).first == m.end()) << std::endl;
+
+		title("erase");
+		for (int i = 0; i < 2000; i += 3)
+			m.erase(i);
+		m.erase(m.begin());
+		m.erase(m.find(1000), m.find(1500));
+		long sum = 0;
+		for (BTREE_MAP(int, int)::iterator it = m.begin(); it != m.end(); ++it)
+			sum += (*it).first;
+		std::cout << m.size() << ' ' << sum << std::endl;
+
+		title("copy and compare");
+		BTREE_MAP(int, int) n(m);
+		std::cout << (n == m) << ' ' << (n < m) << std::endl;
+		n[3000] = 1;
+		std::cout << (n == m) << ' ' << (m < n) << ' ' << n.size() << std::endl;
+	} {
+		title("string keys");
+		BTREE_MAP(std::string, int) m;
+		m["one"] = 1;
+		m["two"] = 2;
+		m["three"] = 3;
+		m.insert(m.end(), ns::make_pair(std::string("zero"), 0));
+		print_map(m);
+		m.erase("two");
+		print_map(m);
+		m.clear();
+		print_map(m);
+	} {
+		title("key aliasing an element");
+		BTREE_MAP(int, int) m;
+		for (int i = 0; i < 4; i++)
+			m[i * 2] = 0;
+		m[6] = 1;
+		m[m[6]] = 70;
+		print_map(m);
+		BTREE_MAP(int, int) n;
+		for (int i = 0; i < 300; i++)
+			n[i * 2] = i * 2 + 1;
+		for (int i = 0; i < 300; i++)
+			n[n[i * 2]] = i;
+		int prev = -1;
+		bool sorted = true;
+		long sum = 0;
+		for (BTREE_MAP(int, int)::iterator it = n.begin(); it != n.end(); ++it)
+		{
+			sorted = sorted && (*it).first > prev;
+			prev = (*it).first;
+			sum += (*it).second;
+		}
+		std::cout << n.size() << ' ' << sorted << ' ' << sum << std::endl;
+	} {
+		title("throwing insert");
+		typedef ns::pair<const int, fragile> fragile_pair;
+		BTREE_MAP(int, fragile) m;
+		for (int i = 0; i < 100; i++)
+			m.insert(fragile_pair(i * 2, fragile(i)));
+		const fragile_pair bad(51, fragile(fragile::poison));
+		fragile::armed = true;
+		for (int hint = 0; hint < 2; hint++)
+		{
+			try {
+				if (hint)
+					m.insert(m.end(), fragile_pair(301, bad.second));
+				else
+					m.insert(bad);
+				std::cout << "Error" << std::endl;
+			} catch (const std::runtime_error&) {
+				std::cout << "Ok" << std::endl;
+			}
+		}
+		fragile::armed = false;
+		long sum = 0;
+		for (BTREE_MAP(int, fragile)::iterator it = m.begin(); it != m.end(); ++it)
+			sum += (*it).first + (*it).second.value;
+		std::cout << m.size() << ' ' << m.count(51) << ' ' << sum << std::endl;
+	}
+}
+
+void compact_map()
+{
+	title("compact_map", 1);
+	{
+		title("insert");
+		COMPACT_MAP(int, int) m;
+		for (int i = 0; i < 2000; i++)
+			m.insert(ns::make_pair((i * 7919) % 2000, i));
+		std::cout << m.size() << ' ' << (*m.begin()).first << ' ' << (*m.rbegin()).first << std::endl;
+		std::cout << m.insert(ns::make_pair(5, 0)).second << ' ' << m[5] << std::endl;
+
+		title("lookup");
+		std::cout << m.count(1999) << ' ' << m.count(2000) << std::endl;
+		std::cout << (*m.find(1234)).second << ' ' << (m.find(-1) == m.end()) << std::endl;
+		std::cout << (*m.lower_bound(100)).first << ' ' << (*m.upper_bound(100)).first << std::endl;
+		std::cout << (m.equal_range(2500).first == m.end()) << std::endl;
+
+		title("erase and reuse");
+		for (int i = 0; i < 2000; i += 3)
+			m.erase(i);
+		m.erase(m.begin());
+		m.erase(m.find(1000), m.find(1500));
+		for (int i = 3000; i < 3100; i++)
+			m.insert(m.end(), ns::make_pair(i, i));
+		long sum = 0;
+		for (COMPACT_MAP(int, int)::reverse_iterator it = m.rbegin(); it != m.rend(); ++it)
+			sum += (*it).first;
+		std::cout << m.size() << ' ' << sum << std::endl;
+
+		title("copy and compare");
+		COMPACT_MAP(int, int) n(m);
+		std::cout << (n == m) << ' ' << (n < m) << std::endl;
+		n[4000] = 1;
+		std::cout << (n == m) << ' ' << (m < n) << ' ' << n.size() << std::endl;
+		n.swap(m);
+		std::cout << n.size() << ' ' << m.size() << std::endl;
+	} {
+		title("string keys");
+		COMPACT_MAP(std::string, int) m;
+		m["one"] = 1;
+		m["two"] = 2;
+		m["three"] = 3;
+		m.insert(m.end(), ns::make_pair(std::string("zero"), 0));
+		print_map(m);
+		m.erase("two");
+		print_map(m);
+		m.clear();
+		print_map(m);
+		m["four"] = 4;
+		print_map(m);
+	}
+}
+
+template<typename T>
+void print_set(const T& set)
+{
+	std::cout << set.size() << std::endl;
+	std::cout << '[';
+	typename T::const_iterator it = set.begin();
+	if (it != set.end())
+		std::cout << *(it++);
+	for (; it != set.end(); ++it)
+		std::cout << ',' << *it;
+	std::cout << ']' << std::endl;
+}
+
+template<typename Map>
+void flat_map_test()
+{
+	Map m;
+	for (int i = 0; i < 500; i++)
+		m[(i * 37) % 500] = i;
+	std::cout << m.size() << ' ' << (*m.begin()).first << ' ' << (*m.rbegin()).first << std::endl;
+	std::cout << m.insert(ns::make_pair(5, 0)).second << ' ' << m[5] << ' ' << m.at(499) << std::endl;
+	std::cout << m.count(250) << ' ' << (m.find(-1) == m.end()) << ' ' << (*m.find(42)).second << std::endl;
+	m.erase(m.lower_bound(100), m.upper_bound(399));
+	std::cout << m.erase(50) << ' ' << m.erase(50) << ' ' << m.size() << std::endl;
+
+	ns::vector<ns::pair<int, int> > batch;
+	for (int i = 0; i < 300; i++)
+		batch.push_back(ns::make_pair((i * 7) % 600, -i));
+	m.insert(batch.begin(), batch.end());
+	std::cout << m.size() << ' ' << m[7] << ' ' << m[598] << std::endl;
+	batch.clear();
+	for (int i = 1000; i < 1010; i++)
+		batch.push_back(ns::make_pair(i, i));
+	m.insert(batch.begin(), batch.end());
+	std::cout << m.size() << ' ' << (*m.rbegin()).second << std::endl;
+
+	ns::pair<typename Map::iterator, typename Map::iterator> range = m.equal_range(1005);
+	std::cout << (*range.first).first << ' ' << (*range.second).first << std::endl;
+	std::cout << m.key_comp()(1, 2) << ' ' << m.value_comp()(*m.begin(), *m.rbegin()) << std::endl;
+
+	Map n(m);
+	std::cout << (n == m) << ' ' << (n < m) << std::endl;
+	n.erase(n.begin());
+	std::cout << (n == m) << ' ' << (m < n) << ' ' << n.size() << std::endl;
+	long sum = 0;
+	for (typename Map::const_iterator it = n.begin(); it != n.end(); ++it)
+		sum += (*it).first + (*it).second;
+	std::cout << sum << std::endl;
+}
+
+void flat_map()
+{
+	title("flat_map", 1);
+	{
+		title("int keys");
+		flat_map_test<FLAT_MAP(int, int)>();
+		title("split storage");
+		flat_map_test<FLAT_MAP_SPLIT(int, int)>();
+	} {
+		title("string keys");
+		FLAT_MAP(std::string, int) m;
+		m["one"] = 1;
+		m["two"] = 2;
+		m["three"] = 3;
+		m.insert(m.end(), ns::make_pair(std::string("zero"), 0));
+		print_map(m);
+		m.erase("two");
+		print_map(m);
+		m.clear();
+		print_map(m);
+	} {
+		title("flat_set");
+		int values[] = { 5, 3, 9, 3, 1, 7, 5, 0 };
+		FLAT_SET(int) s(values, values + 8);
+		print_set(s);
+		s.insert(4);
+		s.insert(s.begin(), -1);
+		std::cout << s.insert(9).second << ' ' << s.count(7) << ' ' << s.erase(3) << std::endl;
+		std::cout << *s.lower_bound(6) << ' ' << *s.upper_bound(7) << ' ' << (s.find(2) == s.end()) << std::endl;
+		int more[] = { 20, 10, 2, 4 };
+		s.insert(more, more + 4);
+		print_set(s);
+	}
+}
+
+void unordered_map()
+{
+	title("unordered_map", 1);
+	{
+		title("insert");
+		UNORDERED_MAP(int, int) m;
+		for (int i = 0; i < 5000; i++)
+			m.insert(ns::make_pair((i * 7919) % 5000, i));
+		std::cout << m.size() << ' ' << m.insert(ns::make_pair(5, 0)).second << ' ' << m[5] << std::endl;
+		m[-1] = 42;
+		std::cout << m.size() << ' ' << m.at(-1) << std::endl;
+
+		title("lookup");
+		std::cout << m.count(4999) << ' ' << m.count(5000) << std::endl;
+		std::cout << (*m.find(1234)).second << ' ' << (m.find(-2) == m.end()) << std::endl;
+		std::cout << ((*m.equal_range(77).first).first) << ' ' << (m.equal_range(-2).first == m.equal_range(-2).second) << std::endl;
+
+		title("erase");
+		for (int i = 0; i < 5000; i += 3)
+			m.erase(i);
+		std::cout << m.erase(3) << ' ' << m.erase(4) << std::endl;
+		long sum = 0;
+		for (UNORDERED_MAP(int, int)::iterator it = m.begin(); it != m.end(); ++it)
+			sum += (*it).first * 3 + (*it).second;
+		std::cout << m.size() << ' ' << sum << std::endl;
+		ns::vector<int> odd;
+		for (UNORDERED_MAP(int, int)::iterator it = m.begin(); it != m.end(); ++it)
+			if ((*it).first % 2)
+				odd.push_back((*it).first);
+		for (size_t i = 0; i < odd.size(); i++)
+			m.erase(odd[i]);
+		sum = 0;
+		for (UNORDERED_MAP(int, int)::const_iterator it = m.begin(); it != m.end(); ++it)
+			sum += (*it).first;
+		std::cout << m.size() << ' ' << sum << std::endl;
+
+		title("copy and compare");
+		UNORDERED_MAP(int, int) n(m);
+		std::cout << (n == m) << ' ' << (n != m) << std::endl;
+		n[100000] = 1;
+		std::cout << (n == m) << ' ' << n.size() << std::endl;
+		n.clear();
+		std::cout << n.empty() << ' ' << (n.begin() == n.end()) << std::endl;
+	} {
+		title("string keys");
+		UNORDERED_MAP(std::string, int) m;
+		m["one"] = 1;
+		m["two"] = 2;
+		m["three"] = 3;
+		m.erase("two");
+		std::cout << m.size() << ' ' << m["one"] << ' ' << m.count("two") << ' ' << m.count("three") << std::endl;
+	} {
+		title("keys from own values");
+		UNORDERED_MAP(int, int) parent;
+		int& r = parent[13];
+		r = 14;
+		parent[r] = 15;
+		for (int i = 0; i < 2000; i++)
+		{
+			parent[i] = i + 5000;
+			parent[parent[i]] = i;
+		}
+		long sum = 0;
+		for (UNORDERED_MAP(int, int)::const_iterator it = parent.begin(); it != parent.end(); ++it)
+			sum += (*it).first * 3 + (*it).second;
+		std::cout << parent.size() << ' ' << sum << ' ' << parent[14] << ' ' << parent[5013] << std::endl;
+	}
+}
+
+struct print_entry
+{
+	template<typename P>
+	void operator()(const P& p) const { std::cout << p.first << ':' << p.second << ' '; }
+};
+
+struct collect_keys
+{
+	explicit collect_keys(ns::vector<int>& keys) : keys(&keys) {}
+	template<typename P>
+	void operator()(const P& p) const { keys->push_back(p.first); }
+
+	ns::vector<int>* keys;
+};
+
+struct add_ten
+{
+	void operator()(int& value) const { value += 10; }
+};
+
+void sharded_map()
+{
+	title("sharded_map", 1);
+	SHARDED_MAP(int, int) m;
+	title("insert");
+	for (int i = 0; i < 2000; i++)
+		m.insert(ns::make_pair((i * 7919) % 2000, i));
+	std::cout << m.size() << ' ' << m.insert(ns::make_pair(5, 0)) << ' ' << m.empty() << std::endl;
+	std::cout << m.insert_or_assign(5, 50) << ' ' << m.insert_or_assign(-1, 7) << ' ' << m.size() << std::endl;
+
+	title("lookup");
+	int value = 0;
+	std::cout << m.find(5, value) << ' ' << value << ' ' << m.find(4000, value) << ' ' << value << std::endl;
+	std::cout << m.count(-1) << ' ' << m.count(2000) << std::endl;
+	std::cout << m.update(5, add_ten()) << ' ' << m.update(4000, add_ten()) << ' ';
+	m.find(5, value);
+	std::cout << value << std::endl;
+
+	title("erase");
+	for (int i = 0; i < 2000; i += 3)
+		m.erase(i);
+	std::cout << m.erase(3) << ' ' << m.erase(4) << ' ' << m.size() << std::endl;
+
+	title("ordered");
+	ns::vector<int> keys;
+	m.for_each(collect_keys(keys));
+	bool sorted = true;
+	for (size_t i = 1; i < keys.size(); i++)
+		sorted = sorted && keys[i - 1] < keys[i];
+	std::cout << keys.size() << ' ' << sorted << ' ' << keys.front() << ' ' << keys.back() << std::endl;
+	m.for_each(100, 110, print_entry());
+	std::cout << std::endl;
+	m.for_each(110, 100, print_entry());
+	std::cout << std::endl;
+
+	title("lower_bound");
+	ns::pair<int, int> found;
+	std::cout << m.lower_bound(1500, found) << ' ' << found.first << ' ' << found.second << std::endl;
+	std::cout << m.lower_bound(-100, found) << ' ' << found.first << ' ' << found.second << std::endl;
+	std::cout << m.lower_bound(2000, found) << ' ' << found.first << std::endl;
+
+	title("clear");
+	m.clear();
+	std::cout << m.size() << ' ' << m.empty() << ' ' << m.lower_bound(0, found) << std::endl;
+}
+
+template<typename Map>
+long weighted_sum(const Map& m)
+{
+	long sum = 0;
+	for (typename Map::const_iterator it = m.begin(); it != m.end(); ++it)
+		sum += (*it).first * 3 + (*it).second;
+	return sum;
+}
+
+void persistent_map()
+{
+	title("persistent_map", 1);
+	PERSISTENT_MAP(int, int) m;
+	title("insert");
+	for (int i = 0; i < 1000; i++)
+		m.insert(ns::make_pair((i * 379) % 1000, i));
+	std::cout << m.size() << ' ' << m.insert(ns::make_pair(5, 0)).second << ' ' << (*m.insert(ns::make_pair(5, 0)).first).second << std::endl;
+	std::cout << MAP_INSERT_OR_ASSIGN(m, 5, 55) << ' ' << MAP_INSERT_OR_ASSIGN(m, -5, 7) << ' ' << m.at(5) << ' ' << m.size() << std::endl;
+
+	title("snapshot");
+	PERSISTENT_MAP(int, int) snap = SNAPSHOT(m);
+	for (int i = 0; i < 1000; i += 2)
+		m.erase(i);
+	for (int i = 1000; i < 1100; i++)
+		m.insert(ns::make_pair(i, -i));
+	MAP_INSERT_OR_ASSIGN(m, 1, 11);
+	std::cout << m.size() << ' ' << weighted_sum(m) << ' ' << m.count(0) << ' ' << m.at(1) << std::endl;
+	std::cout << snap.size() << ' ' << weighted_sum(snap) << ' ' << snap.count(0) << ' ' << snap.at(1) << std::endl;
+	PERSISTENT_MAP(int, int) older = SNAPSHOT(snap);
+	snap.clear();
+	snap.insert(ns::make_pair(3, 3));
+	std::cout << snap.size() << ' ' << older.size() << ' ' << weighted_sum(older) << std::endl;
+
+	title("lookup");
+	std::cout << (*m.lower_bound(500)).first << ' ' << (*m.upper_bound(501)).first << ' ' << (m.find(500) == m.end()) << std::endl;
+	std::cout << (*older.equal_range(500).first).first << ' ' << (*older.equal_range(500).second).first << std::endl;
+	std::cout << (m.lower_bound(2000) == m.end()) << ' ' << (*m.lower_bound(-100)).first << std::endl;
+	try
+	{
+		m.at(2);
+	}
+	catch (const std::out_of_range&)
+	{
+		std::cout << "out_of_range" << std::endl;
+	}
+
+	title("iterate");
+	PERSISTENT_MAP(int, int)::const_reverse_iterator rit = m.rbegin();
+	for (int i = 0; i < 5; i++, ++rit)
+		std::cout << (*rit).first << ' ';
+	PERSISTENT_MAP(int, int)::const_iterator it = m.end();
+	--it;
+	--it;
+	std::cout << (*it).first << ' ' << (*++it).first << ' ' << (++it == m.end()) << std::endl;
+
+	title("compare");
+	PERSISTENT_MAP(int, int) copy(older);
+	std::cout << (copy == older) << ' ' << (copy < m) << ' ';
+	copy.erase(999);
+	std::cout << (copy == older) << ' ' << (copy < older) << ' ' << older.size() << std::endl;
+	m = older;
+	std::cout << m.size() << ' ' << (m == older) << std::endl;
+
+	title("stateful allocator");
+	typedef ns::pair<const int, int> int_pair;
+	PERSISTENT_MAP_ALLOC(int, int, POOL_ALLOCATOR(int_pair)) a;
+	a.insert(ns::make_pair(1, 1));
+	{
+		PERSISTENT_MAP_ALLOC(int, int, POOL_ALLOCATOR(int_pair)) b;
+		for (int i = 0; i < 100; i++)
+			b.insert(ns::make_pair(i, i * i));
+		a = b;
+		b.erase(50);
+	}
+	a.insert(ns::make_pair(-1, 1));
+	std::cout << a.size() << ' ' << (*a.begin()).first << ' ' << weighted_sum(a) << std::endl;
+}
+
+#if __cplusplus >= 201103L
+void concurrent_skiplist_map()
+{
+	title("concurrent_skiplist_map", 1);
+	CONCURRENT_MAP(int, int) m;
+	title("insert");
+	std::cout << m.empty() << ' ' << (m.begin() == m.end()) << std::endl;
+	for (int i = 0; i < 3000; i++)
+		m.insert(ns::make_pair((i * 7919) % 3000, i));
+	ns::pair<CONCURRENT_MAP(int, int)::iterator, bool> res = m.insert(ns::make_pair(5, 0));
+	std::cout << m.size() << ' ' << res.second << ' ' << (*res.first).first << ' ' << (*res.first).second << std::endl;
+	res = m.insert(ns::make_pair(-1, 42));
+	std::cout << m.size() << ' ' << res.second << ' ' << (*res.first).second << std::endl;
+
+	title("lookup");
+	std::cout << m.count(2999) << ' ' << m.count(3000) << ' ' << (m.find(3000) == m.end()) << std::endl;
+	std::cout << (*m.find(1234)).second << ' ' << (*m.lower_bound(-5)).first << ' ' << (m.lower_bound(3000) == m.end()) << std::endl;
+	(*m.find(1234)).second = 7;
+	std::cout << (*m.find(1234)).second << std::endl;
+
+	title("erase");
+	for (int i = 0; i < 3000; i += 3)
+		std::cout << (m.erase(i) ? "" : "missing ");
+	std::cout << m.erase(3) << ' ' << m.erase(4) << ' ' << m.size() << std::endl;
+	std::cout << (*m.lower_bound(2997)).first << ' ' << (*m.lower_bound(1500)).first << std::endl;
+
+	title("iterate");
+	long sum = 0;
+	int prev = -2;
+	bool sorted = true;
+	for (CONCURRENT_MAP(int, int)::iterator it = m.begin(); it != m.end(); ++it)
+	{
+		sorted = sorted && prev < (*it).first;
+		prev = (*it).first;
+		sum += (*it).first * 3 + (*it).second;
+	}
+	std::cout << sorted << ' ' << sum << std::endl;
+	const CONCURRENT_MAP(int, int)& c = m;
+	for (CONCURRENT_MAP(int, int)::const_iterator it = c.lower_bound(10); it != c.end() && (*it).first < 20; ++it)
+		std::cout << (*it).first << ':' << (*it).second << ' ';
+	std::cout << std::endl;
+
+	title("clear");
+	m.clear();
+	std::cout << m.size() << ' ' << m.empty() << ' ' << m.insert(ns::make_pair(1, 1)).second << ' ' << m.size() << std::endl;
 }
+#endif
 
 int main()
 {
 	vector();
+	small_vector();
+	cow_vector();
 	map();
+	btree_map();
+	compact_map();
+	flat_map();
+	unordered_map();
+	sharded_map();
+	persistent_map();
+#if __cplusplus >= 201103L
+	concurrent_skiplist_map();
+#endif
 
 	return 0;
 }
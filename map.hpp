@@ -8,6 +8,7 @@
 #include "iterator.hpp"
 #include "utils.hpp"
 #include "compare.hpp"
+#include "thread_pool.hpp"
 
 namespace ft
 {
@@ -26,106 +27,185 @@ protected:
 	Compare comp;
 };
 
-template <typename Key, typename T, typename Compare = ft::less<Key>, typename Allocator = std::allocator<ft::pair<const Key, T> > >
+// Augment for maps that only keep subtree sizes, see map
+struct order_statistics {};
+
+// Augment summing the mapped values
+template <typename Result>
+struct mapped_sum
+{
+	typedef Result	result_type;
+
+	result_type identity() const { return result_type(); }
+	template <typename Value>
+	result_type lift(const Value& value) const { return value.second; }
+	result_type combine(const result_type& a, const result_type& b) const { return a + b; }
+};
+
+namespace internal
+{
+
+// In-order neighbours kept by the nodes of a threaded map
+template <typename Node, bool Threaded>
+struct thread_links
+{
+	Node*	next;
+	Node*	prev;
+};
+template <typename Node>
+struct thread_links<Node, false> {};
+
+// Size and aggregate of the subtree rooted at a node of an augmented map
+template <typename Augment, typename Size>
+struct subtree_stats
+{
+	typedef typename Augment::result_type	aggregate_type;
+
+	static const bool enabled = true;
+
+	template <typename Value>
+	void update(const subtree_stats* left, const subtree_stats* right, const Value& value)
+	{
+		const Augment augment;
+
+		count = 1;
+		aggregate = augment.lift(value);
+		if (left)
+		{
+			count += left->count;
+			aggregate = augment.combine(left->aggregate, aggregate);
+		}
+		if (right)
+		{
+			count += right->count;
+			aggregate = augment.combine(aggregate, right->aggregate);
+		}
+	}
+
+	Size			count;
+	aggregate_type	aggregate;
+};
+template <typename Size>
+struct subtree_stats<order_statistics, Size>
+{
+	typedef void	aggregate_type;
+
+	static const bool enabled = true;
+
+	template <typename Value>
+	void update(const subtree_stats* left, const subtree_stats* right, const Value&)
+	{
+		count = 1 + (left ? left->count : 0) + (right ? right->count : 0);
+	}
+
+	Size	count;
+};
+template <typename Size>
+struct subtree_stats<void, Size>
+{
+	typedef void	aggregate_type;
+
+	static const bool enabled = false;
+
+	template <typename Value>
+	void update(const subtree_stats*, const subtree_stats*, const Value&) {}
+};
+
+} //internal
+
+// With Threaded set, every node also keeps links to its in-order
+// neighbours, so iterating is a single pointer load per step instead of a
+// walk through the parents, at the cost of two pointers per node.
+// A non void Augment makes every node keep the size of its subtree, which
+// enables nth, rank and count_range in O(log n). Augment is then either
+// order_statistics, or a monoid over the elements enabling aggregate too:
+// a default constructible type with a result_type, result_type identity(),
+// result_type lift(const value_type&) and an associative
+// result_type combine(const result_type&, const result_type&).
+template <typename Key, typename T, typename Compare = ft::less<Key>,
+	typename Allocator = std::allocator<ft::pair<const Key, T> >, bool Threaded = false,
+	typename Augment = void>
 class map
 {
 private:
+	struct NodeBase;
 	struct Node;
+	typedef internal::alloc_traits<Allocator>	alloc_traits;
 
 public:
-	typedef Allocator								allocator_type;
-	typedef typename Allocator::value_type			value_type;
-	typedef Compare									key_compare;
-	typedef map_value_compare<Key, T, key_compare>	value_compare;
-	typedef Key										key_type;
-	typedef T										data_type;
-	typedef T										mapped_type;
-	typedef typename Allocator::pointer				pointer;
-	typedef typename Allocator::const_pointer		const_pointer;
-	typedef typename Allocator::reference			reference;
-	typedef typename Allocator::const_reference		const_reference;
-	typedef typename Allocator::size_type			size_type;
-	typedef typename Allocator::difference_type		difference_type;
+	typedef Allocator									allocator_type;
+	typedef typename alloc_traits::value_type			value_type;
+	typedef Compare										key_compare;
+	typedef map_value_compare<Key, T, key_compare>		value_compare;
+	typedef Key											key_type;
+	typedef T											data_type;
+	typedef T											mapped_type;
+	typedef typename alloc_traits::pointer				pointer;
+	typedef typename alloc_traits::const_pointer		const_pointer;
+	typedef typename alloc_traits::reference			reference;
+	typedef typename alloc_traits::const_reference		const_reference;
+	typedef typename alloc_traits::size_type			size_type;
+	typedef typename alloc_traits::difference_type		difference_type;
+	typedef typename alloc_traits::template rebind<Node>::other	node_allocator;
 
 	template<typename DataType>
 	class MapIterator
 	{
 	public:
-		typedef DataType							value_type;
-		typedef DataType*							pointer;
-		typedef ft::bidirectional_iterator_tag		iterator_category;
-		typedef typename Allocator::difference_type	difference_type;
-		typedef typename Allocator::reference		reference;
+		typedef DataType								value_type;
+		typedef DataType*								pointer;
+		typedef ft::bidirectional_iterator_tag			iterator_category;
+		typedef typename alloc_traits::difference_type	difference_type;
+		typedef typename alloc_traits::reference		reference;
 
 		MapIterator() :
-			_map(NULL),
 			_node(NULL)
 		{}
-		MapIterator(const ft::map<Key, T, Compare, Allocator>* map, Node* node) :
-			_map(map),
+		explicit MapIterator(NodeBase* node) :
 			_node(node)
 		{}
 		MapIterator(const MapIterator& other) :
-			_map(other._map),
 			_node(other._node)
 		{}
 
 		MapIterator& operator=(const MapIterator& other)
 		{
-			_map = other._map;
 			_node = other._node;
 			return *this;
 		}
 
-		reference operator*() const { return _node->value; }
+		reference operator*() const { return static_cast<Node*>(_node)->value; }
 		pointer operator->() const { return &operator*(); }
 
 		MapIterator& operator++() {
-			if (_node)
-				_node = _node->nextNode();
+			_node = _node->nextNode();
 			return *this;
 		}
 		MapIterator operator++(int)
 		{
 			MapIterator tmp = *this;
-			if (_node)
-				_node = _node->nextNode();
+			_node = _node->nextNode();
 			return tmp;
 		}
 
 		MapIterator& operator--() {
-			if (_node)
-				_node = _node->prevNode();
-			else if (_map)
-			{
-				_node = _map->_root;
-				while (_node && _node->right)
-					_node = _node->right;
-			}
+			_node = _node->prevNode();
 			return *this;
 		}
 		MapIterator operator--(int)
 		{
 			MapIterator tmp = *this;
-			if (_node)
-				_node = _node->prevNode();
-			else if (_map)
-			{
-				_node = _map->_root;
-				while (_node && _node->right)
-					_node = _node->right;
-			}
+			_node = _node->prevNode();
 			return tmp;
 		}
 
-		bool operator==(const MapIterator& other) { return _node == other.node(); }
-		bool operator!=(const MapIterator& other) { return _node != other.node(); }
+		bool operator==(const MapIterator& other) const { return _node == other.node(); }
+		bool operator!=(const MapIterator& other) const { return _node != other.node(); }
 
-		const Node* node() const { return _node; }
+		NodeBase* node() const { return _node; }
 
 	private:
-		const ft::map<Key, T, Compare, Allocator>*	_map;
-		Node*										_node;
+		NodeBase*	_node;
 	};
 
 	typedef MapIterator<ft::pair<const Key, T>* >			iterator;
@@ -134,18 +214,17 @@ public:
 	typedef ft::reverse_iterator<const_iterator>			const_reverse_iterator;
 
 private:
-	struct Node
+	// Links shared by the nodes and the header. The header is the end()
+	// node: its parent is the root, its left and right are the smallest and
+	// the biggest nodes, and it is the only one with a height of 0.
+	// Threaded nodes also form a circular list going through the header.
+	// Augmented nodes keep their stats up to date along with their height.
+	struct NodeBase : public internal::thread_links<NodeBase, Threaded>,
+		public internal::subtree_stats<Augment, size_type>
 	{
-		Node(const key_type& key, const data_type& data) :
-			parent(NULL),
-			left(NULL),
-			right(NULL),
-			height(0),
-			value(ft::make_pair(key, data))
-		{
-		}
-		const key_type& key() const { return value.first; }
-		data_type& data() { return value.second; }
+		typedef internal::bool_constant<Threaded>	threaded;
+
+		bool isHeader() const { return height == 0; }
 
 		bool isImbalanced() const
 		{
@@ -161,9 +240,10 @@ private:
 			const size_type hLeft = leftHeight();
 			const size_type hRight = rightHeight();
 			height = ft::max(hLeft, hRight) + 1;
+			this->update(left, right, static_cast<Node*>(this)->value);
 		}
 
-		void replaceChild(Node* old, Node* by)
+		void replaceChild(NodeBase* old, NodeBase* by)
 		{
 			if (left == old)
 				left = by;
@@ -171,10 +251,61 @@ private:
 				right = by;
 		}
 
-		Node* nextNode()
+		NodeBase* nextNode() { return nextNode(threaded()); }
+		NodeBase* prevNode() { return prevNode(threaded()); }
+
+		// Puts this node right after pos in the thread
+		void linkAfter(NodeBase* pos) { linkAfter(pos, threaded()); }
+		void unlink() { unlink(threaded()); }
+		// Makes the thread of the header point back at it
+		void resetThread() { resetThread(threaded()); }
+		void fixThread() { fixThread(threaded()); }
+		// Makes next follow this node in the thread
+		void threadTo(NodeBase* next) { threadTo(next, threaded()); }
+
+		NodeBase* nextNode(internal::true_type) { return this->next; }
+		NodeBase* prevNode(internal::true_type) { return this->prev; }
+		void linkAfter(NodeBase* pos, internal::true_type)
+		{
+			this->prev = pos;
+			this->next = pos->next;
+			pos->next->prev = this;
+			pos->next = this;
+		}
+		void unlink(internal::true_type)
+		{
+			this->prev->next = this->next;
+			this->next->prev = this->prev;
+		}
+		void resetThread(internal::true_type)
+		{
+			this->next = this;
+			this->prev = this;
+		}
+		void fixThread(internal::true_type)
+		{
+			this->next->prev = this;
+			this->prev->next = this;
+		}
+		void threadTo(NodeBase* next, internal::true_type)
+		{
+			this->next = next;
+			next->prev = this;
+		}
+
+		void linkAfter(NodeBase*, internal::false_type) {}
+		void unlink(internal::false_type) {}
+		void resetThread(internal::false_type) {}
+		void fixThread(internal::false_type) {}
+		void threadTo(NodeBase*, internal::false_type) {}
+
+		// The biggest node leads to the header, the header stays put
+		NodeBase* nextNode(internal::false_type)
 		{
-			Node *node = NULL;
+			NodeBase *node = NULL;
 
+			if (isHeader())
+				return this;
 			if (right)
 			{
 				node = right;
@@ -182,26 +313,28 @@ private:
 					node = node->left;
 				return node;
 			}
-			else if (!parent)
-				return NULL;
-			else if (parent->left == this)
-				return parent;
-			else
+			node = this;
+			NodeBase* up = parent;
+			while (node == up->right)
 			{
-				Node* grand = parent->parent;
-
-				if (!grand)
-					return NULL;
-				if (grand->right == parent)
-					return NULL;
-				return grand;
+				node = up;
+				up = up->parent;
 			}
+			// Climbing from the biggest node stops at the header, unless the
+			// root is the biggest node and the climb went through the header
+			if (node->right != up)
+				node = up;
+			return node;
 		}
 
-		Node* prevNode()
+		// The header leads to the biggest node. Going back from the
+		// smallest node is undefined.
+		NodeBase* prevNode(internal::false_type)
 		{
-			Node *node = NULL;
+			NodeBase *node = NULL;
 
+			if (isHeader())
+				return right;
 			if (left)
 			{
 				node = left;
@@ -209,81 +342,198 @@ private:
 					node = node->right;
 				return node;
 			}
-			else if (!parent)
-				return NULL;
-			else if (parent->right == this)
-				return parent;
-			else
+			node = this;
+			NodeBase* up = parent;
+			while (node == up->left)
 			{
-				Node* grand = parent->parent;
-
-				if (!grand)
-					return NULL;
-				if (grand->left == parent)
-					return NULL;
-				return grand;
+				node = up;
+				up = up->parent;
 			}
+			return up;
 		}
 
 		size_type leftHeight() const { return (left) ? left->height : 0; }
 		size_type rightHeight() const { return (right) ? right->height : 0; }
 
-		Node*								parent;
-		Node*								left;
-		Node*								right;
-		size_type							height;
+		NodeBase*	parent;
+		NodeBase*	left;
+		NodeBase*	right;
+		size_type	height;
+	};
+
+	// Nodes are allocated through node_allocator and only their value is
+	// constructed, through the map's allocator (see createNode).
+	struct Node : public NodeBase
+	{
+		const key_type& key() const { return value.first; }
+		data_type& data() { return value.second; }
+
 		ft::pair<const key_type, data_type> value;
 	};
 
+	typedef internal::subtree_stats<Augment, size_type>	stats_type;
+
 public:
 	//constructors
 	map() :
-		_root(NULL),
+		_spare(NULL),
 		_size(0),
 		_comp(Compare()),
-		_alloc(Allocator())
+		_alloc(Allocator()),
+		_node_alloc(_alloc)
 	{
+		resetHeader();
 	}
 	explicit map(const key_compare& comp, const allocator_type& alloc = allocator_type()) :
-		_root(NULL),
+		_spare(NULL),
 		_size(0),
 		_comp(comp),
-		_alloc(alloc)
+		_alloc(alloc),
+		_node_alloc(_alloc)
 	{
+		resetHeader();
 	}
 	template <typename InputIt>
 	map(InputIt first, InputIt last, const key_compare& comp = key_compare(),
 		const allocator_type& alloc = allocator_type(),
 	typename ft::enable_if<!ft::is_integral<InputIt>::value, InputIt>::type* = NULL) :
-		_root(NULL),
+		_spare(NULL),
 		_size(0),
 		_comp(comp),
-		_alloc(alloc)
+		_alloc(alloc),
+		_node_alloc(_alloc)
 	{
-		for (; first != last; ++first)
-			insert(*first);
+		resetHeader();
+		build(first, last, true);
+	}
+	// Builds a balanced tree in O(n), [first, last) must be sorted and
+	// hold no duplicate keys
+	template <typename InputIt>
+	map(from_sorted_t, InputIt first, InputIt last, const key_compare& comp = key_compare(),
+		const allocator_type& alloc = allocator_type()) :
+		_spare(NULL),
+		_size(0),
+		_comp(comp),
+		_alloc(alloc),
+		_node_alloc(_alloc)
+	{
+		resetHeader();
+		build(first, last, false);
 	}
 	map(const map& other) :
-		_root(NULL),
+		_spare(NULL),
 		_size(0),
 		_comp(other._comp),
-		_alloc(other._alloc)
+		_alloc(other._alloc),
+		_node_alloc(other._node_alloc)
 	{
+		resetHeader();
 		*this = other;
 	}
 	map& operator=(const map& other)
 	{
 		if (this == &other)
 			return *this;
-		clear();
+		clear(true);
+		if (_node_alloc != other._node_alloc)
+			releaseSpare();
 
 		_comp = other._comp;
 		_alloc = other._alloc;
-		for (const_iterator it = other.begin(); it != other.end(); ++it)
-			insert(*it);
+		_node_alloc = other._node_alloc;
+		if (other.root())
+		{
+			NodeBase* last = &_header;
+			_header.parent = clone(other.root(), &_header, last);
+			_header.left = smallest(_header.parent);
+			_header.right = biggest(_header.parent);
+		}
+		_size = other._size;
+		releaseSpare();
+		return *this;
+	}
+
+#ifdef FT_CXX11
+	map(map&& other) :
+		_header(other._header),
+		_spare(NULL),
+		_size(other._size),
+		_comp(std::move(other._comp)),
+		_alloc(other._alloc),
+		_node_alloc(other._node_alloc)
+	{
+		fixHeader();
+		other.resetHeader();
+		other._size = 0;
+	}
+	map& operator=(map&& other)
+	{
+		if (this == &other)
+			return *this;
+		clear();
+		swap(other);
 		return *this;
 	}
 
+	// The parallel bulk operations cut the tree a few levels below the
+	// root, into about 8 subtrees per thread of the pool, each handled by
+	// one task. The nodes above the cut are handled by the calling thread.
+	// The allocators have to be thread safe.
+
+	// Copies other, keeping its shape
+	map(const map& other, thread_pool& pool) :
+		_spare(NULL),
+		_size(0),
+		_comp(other._comp),
+		_alloc(other._alloc),
+		_node_alloc(other._node_alloc)
+	{
+		resetHeader();
+		if (!other.root())
+			return;
+		const size_type depth = cutDepth(pool);
+		std::vector<CloneTask> tasks;
+
+		cloneSpine(other.root(), &_header, &_header.parent, depth, tasks);
+		pool.run(tasks.size(), [&](std::size_t i)
+		{
+			*tasks[i].slot = cloneShape(tasks[i].src, tasks[i].parent);
+		});
+		_header.left = smallest(root());
+		_header.right = biggest(root());
+		_size = other._size;
+		threadParallel(depth, pool);
+	}
+	// Same as the from_sorted constructor, for a random access range
+	template <typename RandomIt>
+	map(from_sorted_t, RandomIt first, RandomIt last, thread_pool& pool,
+		const key_compare& comp = key_compare(), const allocator_type& alloc = allocator_type()) :
+		_spare(NULL),
+		_size(0),
+		_comp(comp),
+		_alloc(alloc),
+		_node_alloc(_alloc)
+	{
+		resetHeader();
+		const size_type n = last - first;
+		if (!n)
+			return;
+		const size_type depth = cutDepth(pool);
+		std::vector<BuildTask<RandomIt> > tasks;
+
+		buildSpine(first, n, &_header, &_header.parent, depth, tasks);
+		pool.run(tasks.size(), [&](std::size_t i)
+		{
+			*tasks[i].slot = buildRange(tasks[i].first, tasks[i].count, tasks[i].parent);
+		});
+		updateSpine(root(), depth);
+		_header.left = smallest(root());
+		_header.right = biggest(root());
+		_size = n;
+		threadParallel(depth, pool);
+	}
+#endif
+
 	~map()
 	{
 		clear();
@@ -308,17 +558,29 @@ public:
 	}
 	T& operator[](const key_type& key)
 	{
-		iterator it = find(key);
-		if (it == end())
-			it = insert(ft::make_pair(key, data_type())).first;
-		return (*it).second;
+#ifdef FT_CXX11
+		return (*try_emplace(key).first).second;
+#else
+		NodeBase* parent;
+		bool left;
+		NodeBase* node = findPos(key, parent, left);
+		if (!node)
+			node = attach(createNode(value_type(key, data_type())), parent, left);
+		return static_cast<Node*>(node)->data();
+#endif
+	}
+#ifdef FT_CXX11
+	T& operator[](key_type&& key)
+	{
+		return (*try_emplace(std::move(key)).first).second;
 	}
+#endif
 
 	//iterators
-	iterator begin() { return iterator(this, smallest(_root)); }
-	const_iterator begin() const { return const_iterator(this, smallest(_root)); }
-	iterator end() { return iterator(this, NULL); }
-	const_iterator end() const { return const_iterator(this, NULL); }
+	iterator begin() { return iterator(_header.left); }
+	const_iterator begin() const { return const_iterator(_header.left); }
+	iterator end() { return iterator(&_header); }
+	const_iterator end() const { return const_iterator(header()); }
 
 	reverse_iterator rbegin() { return reverse_iterator(end()); }
 	const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
@@ -328,192 +590,286 @@ public:
 	//capacity
 	bool empty() const { return _size == 0; }
 	size_type size() const { return _size; }
-	size_type max_size() const { return _alloc.max_size(); }
+	size_type max_size() const { return internal::alloc_traits<node_allocator>::max_size(_node_alloc); }
 
 	//modifiers
-	void clear()
+	// With keep_nodes, the nodes are kept aside and reused by the next
+	// insertions instead of being freed. A plain clear() frees them all.
+	void clear(bool keep_nodes = false)
 	{
-		if (_root)
-			deleteNodeAndChild(_root);
-		_root = NULL;
+		if (root())
+			deleteNodeAndChild(root(), keep_nodes);
+		if (!keep_nodes)
+			releaseSpare();
+		resetHeader();
 		_size = 0;
 	}
 
+#ifdef FT_CXX11
+	// Frees the subtrees below the cut in parallel, see map(const map&, thread_pool&)
+	void clear(thread_pool& pool)
+	{
+		const size_type depth = cutDepth(pool);
+		std::vector<NodeBase*> cut;
+
+		cutTree(root(), depth, cut);
+		pool.run(cut.size(), [&](std::size_t i) { deleteNodeAndChild(cut[i]); });
+		deleteSpine(root(), depth);
+		releaseSpare();
+		resetHeader();
+		_size = 0;
+	}
+#endif
+
 	ft::pair<iterator,bool> insert(const value_type& value)
 	{
-		iterator it = find(value.first);
-		if (it != end())
-			return ft::make_pair(it, false);
+		NodeBase* parent;
+		bool left;
+		NodeBase* node = findPos(value.first, parent, left);
+		if (node)
+			return ft::make_pair(iterator(node), false);
+		return ft::make_pair(iterator(attach(createNode(value), parent, left)), true);
+	}
+#ifdef FT_CXX11
+	ft::pair<iterator,bool> insert(value_type&& value)
+	{
+		NodeBase* parent;
+		bool left;
+		NodeBase* node = findPos(value.first, parent, left);
+		if (node)
+			return ft::make_pair(iterator(node), false);
+		return ft::make_pair(iterator(attach(createNode(std::move(value)), parent, left)), true);
+	}
 
-		const key_type& key = value.first;
-		Node* node = _root;
-		while (node)
+	template<typename... Args>
+	ft::pair<iterator,bool> emplace(Args&&... args)
+	{
+		Node* node = createNode(std::forward<Args>(args)...);
+		NodeBase* parent;
+		bool left;
+		NodeBase* found = findPos(node->key(), parent, left);
+		if (found)
 		{
-			if (node->key() == key)
-				break;
-			if (_comp(key, node->key()))
-			{
-				if (!node->left)
-					break;
-				node = node->left;
-			}
-			else
-			{
-				if (!node->right)
-					break;
-				node = node->right;
-			}
+			destroyNode(node);
+			return ft::make_pair(iterator(found), false);
 		}
-		Node* child = new Node(value.first, value.second);
-		child->height = 1;
-		if (!node)
+		return ft::make_pair(iterator(attach(node, parent, left)), true);
+	}
+	template<typename... Args>
+	iterator emplace_hint(iterator hint, Args&&... args)
+	{
+		Node* node = createNode(std::forward<Args>(args)...);
+		NodeBase* parent;
+		bool left;
+		NodeBase* found = findHintPos(hint, node->key(), parent, left);
+		if (found)
 		{
-			_root = child;
-			_size = 1;
-			return ft::make_pair(iterator(this, _root), true);
+			destroyNode(node);
+			return iterator(found);
 		}
-		child->parent = node;
-		if (_comp(key, node->key()))
-			node->left = child;
-		else
-			node->right = child;
-		recount(node);
-		rebalance(node);
-		_size++;
-		return ft::make_pair(iterator(this, child), true);
+		return iterator(attach(node, parent, left));
+	}
+
+	template<typename... Args>
+	ft::pair<iterator,bool> try_emplace(const key_type& key, Args&&... args)
+	{
+		NodeBase* parent;
+		bool left;
+		NodeBase* node = findPos(key, parent, left);
+		if (node)
+			return ft::make_pair(iterator(node), false);
+		return ft::make_pair(iterator(attach(createNode(key,
+			mapped_type(std::forward<Args>(args)...)), parent, left)), true);
+	}
+	template<typename... Args>
+	ft::pair<iterator,bool> try_emplace(key_type&& key, Args&&... args)
+	{
+		NodeBase* parent;
+		bool left;
+		NodeBase* node = findPos(key, parent, left);
+		if (node)
+			return ft::make_pair(iterator(node), false);
+		return ft::make_pair(iterator(attach(createNode(std::move(key),
+			mapped_type(std::forward<Args>(args)...)), parent, left)), true);
 	}
+#endif
 	iterator insert(iterator position, const value_type& value)
 	{
-		(void)position;
-		return insert(value).first;
+		NodeBase* parent;
+		bool left;
+		NodeBase* node = findHintPos(position, value.first, parent, left);
+		if (node)
+			return iterator(node);
+		return iterator(attach(createNode(value), parent, left));
 	}
 	template <typename InputIt>
 	void insert(InputIt first, InputIt last,
 	typename ft::enable_if<!ft::is_integral<InputIt>::value, InputIt>::type* = NULL)
 	{
-		map cpy(first, last, _comp, _alloc);
-
-		iterator it = cpy.begin();
-		for (; it != cpy.end(); ++it)
-			insert(*it);
+		if (empty())
+			build(first, last, true);
+		else
+			for (; first != last; ++first)
+				insert(end(), *first);
 	}
 
 	void erase(iterator position)
 	{
 		if (position != end())
-			erase((*position).first);
+			eraseNode(position.node());
 	}
+	// The range is cut out of the tree with two splits and the rest joined
+	// back, in O(log n) plus the erased nodes
 	void erase(iterator first, iterator last)
 	{
-		map cpy(first, last, _comp, _alloc);
-
-		iterator it = cpy.begin();
-		for (; it != cpy.end(); ++it)
-			erase((*it).first);
+		if (first == last)
+			return;
+		if (first == begin() && last == end())
+		{
+			clear();
+			return;
+		}
+		NodeBase* before = (first == begin()) ? header() : first.node()->prevNode();
+		NodeBase* after = last.node();
+		NodeBase* left;
+		NodeBase* rest;
+		NodeBase* mid = NULL;
+		NodeBase* right = NULL;
+
+		splitTree(root(), key(first.node()), left, rest);
+		if (after->isHeader())
+			mid = rest;
+		else
+			splitTree(rest, key(after), mid, right);
+		_size -= deleteNodeAndChild(mid);
+		setRoot(joinTrees(left, right), before->isHeader() ? after : _header.left,
+			after->isHeader() ? before : _header.right);
+		before->threadTo(after);
 	}
 	size_type erase(const key_type& key)
 	{
-		Node* node = _root;
-		while (node)
-		{
-			if (node->key() == key)
-				break;
-			if (_comp(key, node->key()))
-				node = node->left;
-			else
-				node = node->right;
-		}
-		if (!node)
+		iterator it = find(key);
+		if (it == end())
 			return 0;
+		eraseNode(it.node());
+		return 1;
+	}
 
-		Node* parent = node->parent;
-		if (node->height == 1)
+	// Moves the elements with a key not less than key into other, dropping
+	// what other held. Costs O(log n), plus walking the smaller side to
+	// count it when the map keeps no subtree sizes. Elements are copied
+	// when the node allocators differ.
+	void split(const key_type& key, map& other)
+	{
+		if (&other == this)
+			return;
+		NodeBase* cut = lower(key);
+
+		other.clear();
+		if (cut->isHeader())
+			return;
+		if (_node_alloc != other._node_alloc)
 		{
-			if (parent)
-				parent->replaceChild(node, NULL);
-			else
-				_root = NULL;
+			iterator first(cut);
+			for (iterator it = first; it != end(); ++it)
+				other.insert(other.end(), *it);
+			erase(first, end());
+			return;
 		}
-		else if (node->left && node->right)
+		if (cut == _header.left)
 		{
-			Node* newNode = smallest(node);
-			Node* newNodeParent = newNode->parent;
-
-			newNodeParent->replaceChild(newNode, NULL);
-			if (parent)
-				parent->replaceChild(node, newNode);
-			newNode->parent = parent;
-			newNode->left = node->left;
-			newNode->right = node->right;
-			if (newNode->left)
-				newNode->left->parent = newNode;
-			if (newNode->right)
-				newNode->right->parent = newNode;
-			newNode->height = node->height;
+			swap(other);
+			return;
 		}
-		else
+		const size_type moved = countFrom(cut, internal::bool_constant<stats_type::enabled>());
+		NodeBase* before = cut->prevNode();
+		NodeBase* last = _header.right;
+		NodeBase* left;
+		NodeBase* right;
+
+		splitTree(root(), key, left, right);
+		setRoot(left, _header.left, before);
+		other.setRoot(right, cut, last);
+		before->threadTo(&_header);
+		other._header.threadTo(cut);
+		last->threadTo(&other._header);
+		_size -= moved;
+		other._size = moved;
+	}
+	// Moves all the elements of other, whose keys must all be greater than
+	// the ones of this map, in O(log n). Elements are copied when the node
+	// allocators differ.
+	void join(map& other)
+	{
+		if (&other == this || other.empty())
+			return;
+		if (_node_alloc != other._node_alloc)
 		{
-			Node* newNode = node->right;
-			if (node->left)
-				newNode = node->left;
-
-			newNode->parent = parent;
-			if (parent)
-				parent->replaceChild(node, newNode);
-			else
-				_root = newNode;
+			for (iterator it = other.begin(); it != other.end(); ++it)
+				insert(end(), *it);
+			other.clear();
+			return;
 		}
-		if (parent)
+		if (empty())
 		{
-			recount(parent->left);
-			recount(parent->right);
-			rebalance(parent->left);
-			rebalance(parent->right);
+			swap(other);
+			return;
 		}
-
-		_size--;
-		delete node;
-		return 1;
+		NodeBase* last = _header.right;
+		NodeBase* first = other._header.left;
+		NodeBase* otherLast = other._header.right;
+		NodeBase* right = other.root();
+
+		_size += other._size;
+		other._size = 0;
+		other.resetHeader();
+		setRoot(joinTrees(root(), right), _header.left, otherLast);
+		last->threadTo(first);
+		otherLast->threadTo(&_header);
+	}
+	// Moves the elements of other whose key is not in this map, keeping
+	// their nodes. Unless other is small enough to be inserted node by node,
+	// both maps are flattened to lists, merged and rebuilt in linear time.
+	// Elements are copied when the node allocators differ.
+	void merge(map& other)
+	{
+		if (this == &other || other.empty())
+			return;
+		if (_node_alloc != other._node_alloc)
+		{
+			mergeCopies(other);
+			return;
+		}
+		if (empty())
+		{
+			swap(other);
+			return;
+		}
+		size_type depth = 1;
+		for (size_type n = _size; n > 1; n >>= 1)
+			depth++;
+		if (other._size * depth < _size)
+			mergeNodes(other);
+		else
+			mergeLists(other);
 	}
 
 	void swap(map& other)
 	{
-		ft::swap(_root, other._root);
+		ft::swap(_header, other._header);
+		fixHeader();
+		other.fixHeader();
+		ft::swap(_spare, other._spare);
 		ft::swap(_size, other._size);
 		ft::swap(_comp, other._comp);
 		ft::swap(_alloc, other._alloc);
+		ft::swap(_node_alloc, other._node_alloc);
 	}
 
 	//lookup
 	size_type count(const key_type& key) const { return find(key) != end(); }
-	iterator find(const key_type& key)
-	{
-		Node* node = _root;
-		while (node)
-		{
-			if (node->key() == key)
-				return iterator(this, node);
-			if (_comp(key, node->key()))
-				node = node->left;
-			else
-				node = node->right;
-		}
-		return iterator(this, NULL);
-	}
-	const_iterator find(const key_type& key) const
-	{
-		Node* node = _root;
-		while (node)
-		{
-			if (node->key() == key)
-				return const_iterator(this, node);
-			if (_comp(key, node->key()))
-				node = node->left;
-			else
-				node = node->right;
-		}
-		return const_iterator(this, NULL);
-	}
+	iterator find(const key_type& key) { return iterator(findNode(key)); }
+	const_iterator find(const key_type& key) const { return const_iterator(findNode(key)); }
 	ft::pair<iterator,iterator> equal_range(const key_type& key) {
 		return ft::make_pair(lower_bound(key), upper_bound(key));
 	}
@@ -522,127 +878,1023 @@ public:
 	}
 
 	iterator lower_bound(const key_type& key) {
-		return iterator(this, lower(key));
+		return iterator(lower(key));
 	}
 	const_iterator lower_bound(const key_type& key) const {
-		return const_iterator(this, lower(key));
+		return const_iterator(lower(key));
 	}
 
 	iterator upper_bound(const key_type& key) {
-		return iterator(this, higher(key));
+		return iterator(higher(key));
 	}
 	const_iterator upper_bound(const key_type& key) const {
-		return const_iterator(this, higher(key));
-	}
-
-	//observers
-	key_compare key_comp() const { return _comp; }
-	value_compare value_comp() const { return value_compare(_comp); }
-
-private:
-	Node* smallest(Node* node) const
-	{
-		if (!node)
-			return NULL;
-		while (node->left)
-			node = node->left;
-		return node;
-	}
-	Node* biggest(Node* node) const
-	{
-		if (!node)
-			return NULL;
-		while (node->right)
-			node = node->right;
-		return node;
+		return const_iterator(higher(key));
 	}
 
-	Node* lower(const key_type& key) const
+	//order statistics, for augmented maps
+	// The element at index k in key order, end() when k >= size()
+	iterator nth(size_type k) { return iterator(nthNode(k)); }
+	const_iterator nth(size_type k) const { return const_iterator(nthNode(k)); }
+	// Number of keys below key
+	size_type rank(const key_type& key) const
 	{
-		Node* current = _root;
-		Node* res = NULL;
+		NodeBase* node = root();
+		size_type res = 0;
 
-		while (current)
+		while (node)
 		{
-			if (_comp(key, current->key()))
+			if (_comp(this->key(node), key))
 			{
-				res = current;
-				current = current->left;
+				res += subtreeSize(node->left) + 1;
+				node = node->right;
 			}
-			else if (_comp(current->key(), key))
-				current = current->right;
 			else
-				return current;
+				node = node->left;
 		}
 		return res;
 	}
-	Node* higher(const key_type& key) const
+	// Number of keys in [lo, hi)
+	size_type count_range(const key_type& lo, const key_type& hi) const
 	{
-		Node* current = _root;
-		Node* res = NULL;
-
-		while (current)
-		{
-			if (_comp(key, current->key()))
-			{
-				res = current;
-				current = current->left;
-			}
-			else
-				current = current->right;
-		}
-		return res;
+		if (!_comp(lo, hi))
+			return 0;
+		return rank(hi) - rank(lo);
 	}
-
-	void deleteNodeAndChild(Node *node)
+	// Aggregate of the elements with a key in [lo, hi), combined in key
+	// order. Needs a monoid Augment.
+	typename stats_type::aggregate_type aggregate(const key_type& lo, const key_type& hi) const
 	{
-		if (node->left)
-			deleteNodeAndChild(node->left);
-		if (node->right)
-			deleteNodeAndChild(node->right);
-		delete node;
+		if (!_comp(lo, hi))
+			return Augment().identity();
+		return aggregateRange(root(), &lo, &hi);
 	}
-
-	void recount(Node* from)
+	// Recomputes the aggregates depending on the element at position, to
+	// be called after changing its mapped value
+	void refresh(iterator position)
 	{
-		for (; from; from = from->parent)
-			from->updateHeight();
+		if (position != end())
+			recount(position.node());
 	}
 
-	void rebalance(Node* from)
+#ifdef FT_CXX11
+	//parallel
+	// Calls fn on every element, from several threads and in no particular
+	// order, see map(const map&, thread_pool&)
+	template <typename Fn>
+	void parallel_for_each(Fn fn, thread_pool& pool)
 	{
-		Node* tmp;
+		const size_type depth = cutDepth(pool);
+		std::vector<NodeBase*> cut;
 
-		for (; from; from = from->parent)
+		cutTree(root(), depth, cut);
+		pool.run(cut.size(), [&](std::size_t i) { forEachNode(cut[i], fn); });
+		forEachSpine(root(), depth, fn);
+	}
+#endif
+
+	//observers
+	key_compare key_comp() const { return _comp; }
+	value_compare value_comp() const { return value_compare(_comp); }
+
+private:
+	void eraseNode(NodeBase* node)
+	{
+		unlinkNode(node);
+		destroyNode(static_cast<Node*>(node));
+	}
+	// Takes a node out of the tree, without destroying it
+	void unlinkNode(NodeBase* node)
+	{
+		if (node == _header.right)
+			_header.right = (node == _header.left) ? &_header : node->prevNode();
+		if (node == _header.left)
+			_header.left = node->nextNode();
+		node->unlink();
+		NodeBase* from = node->parent;
+		if (node->left && node->right)
 		{
-			if (!from->isImbalanced())
-				continue;
-			if (from->rightHeight() > from->leftHeight())
-			{
-				tmp = from->right;
-				if (tmp->rightHeight() < tmp->leftHeight())
-					rotateRight(tmp);
-				from = rotateLeft(from);
-			}
-			else
+			NodeBase* newNode = smallest(node->right);
+
+			from = newNode;
+			if (newNode->parent != node)
 			{
-				tmp = from->left;
-				if (tmp->rightHeight() > tmp->leftHeight())
-					rotateLeft(tmp);
-				from = rotateRight(from);
+				from = newNode->parent;
+				from->left = newNode->right;
+				if (newNode->right)
+					newNode->right->parent = from;
+				newNode->right = node->right;
+				newNode->right->parent = newNode;
 			}
+			newNode->left = node->left;
+			newNode->left->parent = newNode;
+			newNode->height = node->height;
+			replace(node, newNode);
 		}
+		else
+			replace(node, node->left ? node->left : node->right);
+		recount(from);
+		rebalance(from);
+		_size--;
 	}
 
-	Node* rotateLeft(Node* node)
-	{
-		Node* newNode = node->right;
-		Node* tmp = newNode->left;
-		Node* parent = node->parent;
+	NodeBase* header() const { return const_cast<NodeBase*>(&_header); }
+	NodeBase* root() const { return _header.parent; }
+	static const key_type& key(const NodeBase* node) { return static_cast<const Node*>(node)->key(); }
 
-		node->right = tmp;
-		if (tmp)
-			tmp->parent = node;
+	void resetHeader()
+	{
+		_header.parent = NULL;
+		_header.left = &_header;
+		_header.right = &_header;
+		_header.height = 0;
+		_header.resetThread();
+	}
+	// Points the root back to this header after the links were copied
+	// from another map
+	void fixHeader()
+	{
+		if (root())
+		{
+			root()->parent = &_header;
+			_header.fixThread();
+		}
+		else
+			resetHeader();
+	}
+
+	Node* createNode(const value_type& value)
+	{
+		Node* node = newNode();
+		alloc_traits::construct(_alloc, &node->value, value);
+		return node;
+	}
+#ifdef FT_CXX11
+	template<typename... Args>
+	Node* createNode(Args&&... args)
+	{
+		Node* node = newNode();
+		alloc_traits::construct(_alloc, &node->value, std::forward<Args>(args)...);
+		return node;
+	}
+#endif
+	// Takes a spare node if there is one, its value is left unconstructed.
+	// The links are constructed here, as augmented nodes may hold an
+	// aggregate that is not trivial.
+	Node* newNode()
+	{
+		Node* node = _spare;
+
+		if (node)
+			_spare = static_cast<Node*>(node->right);
+		else
+			node = _node_alloc.allocate(1);
+		new (static_cast<void*>(node)) NodeBase;
+		node->parent = NULL;
+		node->left = NULL;
+		node->right = NULL;
+		node->height = 1;
+		return node;
+	}
+	// Spare nodes are chained through their right pointer
+	void destroyNode(Node* node, bool keep = false)
+	{
+		alloc_traits::destroy(_alloc, &node->value);
+		static_cast<NodeBase*>(node)->~NodeBase();
+		if (keep)
+		{
+			node->right = _spare;
+			_spare = node;
+		}
+		else
+			_node_alloc.deallocate(node, 1);
+	}
+	void releaseSpare()
+	{
+		while (_spare)
+		{
+			Node* next = static_cast<Node*>(_spare->right);
+			_node_alloc.deallocate(_spare, 1);
+			_spare = next;
+		}
+	}
+
+	NodeBase* findNode(const key_type& key) const
+	{
+		NodeBase* node = root();
+		while (node)
+		{
+			if (this->key(node) == key)
+				return node;
+			if (_comp(key, this->key(node)))
+				node = node->left;
+			else
+				node = node->right;
+		}
+		return header();
+	}
+
+	// Looks for key in a single descent. Returns its node, or NULL with
+	// parent and left telling where a node for it has to be attached.
+	NodeBase* findPos(const key_type& key, NodeBase*& parent, bool& left) const
+	{
+		NodeBase* node = root();
+
+		parent = header();
+		left = false;
+		while (node)
+		{
+			parent = node;
+			if (_comp(key, this->key(node)))
+			{
+				left = true;
+				node = node->left;
+			}
+			else if (_comp(this->key(node), key))
+			{
+				left = false;
+				node = node->right;
+			}
+			else
+				return node;
+		}
+		return NULL;
+	}
+
+	// Same as findPos, but when key belongs right next to hint it is
+	// attached there without descending from the root.
+	NodeBase* findHintPos(iterator hint, const key_type& key, NodeBase*& parent, bool& left) const
+	{
+		NodeBase* pos = hint.node();
+
+		if (pos->isHeader())
+		{
+			if (_size && _comp(this->key(_header.right), key))
+			{
+				parent = _header.right;
+				left = false;
+				return NULL;
+			}
+		}
+		else if (_comp(key, this->key(pos)))
+		{
+			NodeBase* prev = (pos == _header.left) ? NULL : pos->prevNode();
+			if (!prev || _comp(this->key(prev), key))
+			{
+				left = !pos->left;
+				parent = left ? pos : prev;
+				return NULL;
+			}
+		}
+		else if (_comp(this->key(pos), key))
+		{
+			NodeBase* next = pos->nextNode();
+			if (next->isHeader() || _comp(key, this->key(next)))
+			{
+				left = pos->right != NULL;
+				parent = left ? next : pos;
+				return NULL;
+			}
+		}
+		else
+			return pos;
+		return findPos(key, parent, left);
+	}
+
+	// Links a new node where findPos or findHintPos said it goes
+	NodeBase* attach(NodeBase* child, NodeBase* parent, bool left)
+	{
+		child->parent = parent;
+		if (Threaded)
+			child->linkAfter(left ? parent->prevNode() : parent);
+		if (stats_type::enabled)
+			child->updateHeight();
+		_size++;
+		if (parent->isHeader())
+		{
+			_header.parent = child;
+			_header.left = child;
+			_header.right = child;
+			return child;
+		}
+		if (left)
+		{
+			parent->left = child;
+			if (parent == _header.left)
+				_header.left = child;
+		}
+		else
+		{
+			parent->right = child;
+			if (parent == _header.right)
+				_header.right = child;
+		}
+		rebalanceInsert(parent);
+		return child;
+	}
+
+	// Fills an empty map. Nodes are chained through their right pointer
+	// while the input is sorted, then turned into a balanced tree in one
+	// pass. If check is set and a key is out of order, the rest of the
+	// range is inserted normally.
+	template <typename InputIt>
+	void build(InputIt& first, InputIt last, bool check)
+	{
+		NodeBase* head = NULL;
+		NodeBase* tail = NULL;
+		size_type count = 0;
+
+		for (; first != last; ++first)
+		{
+			if (check && tail && !_comp(key(tail), (*first).first))
+				break;
+			Node* node = createNode(*first);
+			node->linkAfter(tail ? tail : &_header);
+			if (tail)
+				tail->right = node;
+			else
+				head = node;
+			tail = node;
+			count++;
+		}
+		if (count)
+		{
+			_header.left = head;
+			_header.right = tail;
+			_header.parent = buildTree(head, count, &_header);
+			_size = count;
+		}
+		for (; first != last; ++first)
+			insert(end(), *first);
+	}
+
+	// Moves the nodes of other one at a time
+	void mergeNodes(map& other)
+	{
+		NodeBase* node = other._header.left;
+
+		while (!node->isHeader())
+		{
+			NodeBase* next = node->nextNode();
+			NodeBase* parent;
+			bool left;
+			if (!findPos(key(node), parent, left))
+			{
+				other.unlinkNode(node);
+				node->left = NULL;
+				node->right = NULL;
+				node->height = 1;
+				attach(node, parent, left);
+			}
+			node = next;
+		}
+	}
+
+	// Copies the elements of other whose key is not here, erasing them
+	// from other
+	void mergeCopies(map& other)
+	{
+		iterator it = other.begin();
+
+		while (it != other.end())
+		{
+			if (insert(*it).second)
+				other.erase(it++);
+			else
+				++it;
+		}
+	}
+
+	// Merges the in-order lists of both trees, the nodes of other with a
+	// key already here going to a second list, and rebuilds both maps
+	void mergeLists(map& other)
+	{
+		NodeBase* mine = NULL;
+		NodeBase* theirs = NULL;
+		NodeBase* tail = NULL;
+		NodeBase* otherTail = NULL;
+		NodeBase* head = NULL;
+		NodeBase* otherHead = NULL;
+		size_type count = 0;
+		size_type otherCount = 0;
+
+		flatten(root(), mine, tail);
+		tail->right = NULL;
+		flatten(other.root(), theirs, otherTail);
+		otherTail->right = NULL;
+		resetHeader();
+		other.resetHeader();
+		tail = NULL;
+		otherTail = NULL;
+		while (mine || theirs)
+		{
+			NodeBase* node;
+			if (!theirs || (mine && _comp(key(mine), key(theirs))))
+			{
+				node = mine;
+				mine = mine->right;
+			}
+			else if (!mine || _comp(key(theirs), key(mine)))
+			{
+				node = theirs;
+				theirs = theirs->right;
+			}
+			else
+			{
+				node = theirs;
+				theirs = theirs->right;
+				node->linkAfter(otherTail ? otherTail : &other._header);
+				if (otherTail)
+					otherTail->right = node;
+				else
+					otherHead = node;
+				otherTail = node;
+				otherCount++;
+				continue;
+			}
+			node->linkAfter(tail ? tail : &_header);
+			if (tail)
+				tail->right = node;
+			else
+				head = node;
+			tail = node;
+			count++;
+		}
+		_size = count;
+		_header.left = head;
+		_header.right = tail;
+		_header.parent = buildTree(head, count, &_header);
+		other._size = otherCount;
+		if (otherCount)
+		{
+			other._header.left = otherHead;
+			other._header.right = otherTail;
+			other._header.parent = other.buildTree(otherHead, otherCount, &other._header);
+		}
+	}
+
+	// Chains the nodes of a subtree in order through their right pointer,
+	// after tail
+	static void flatten(NodeBase* node, NodeBase*& head, NodeBase*& tail)
+	{
+		if (!node)
+			return;
+		NodeBase* right = node->right;
+
+		flatten(node->left, head, tail);
+		if (tail)
+			tail->right = node;
+		else
+			head = node;
+		tail = node;
+		flatten(right, head, tail);
+	}
+
+	// Turns the first n nodes of a right-chained list into a balanced
+	// tree, advancing head past them
+	NodeBase* buildTree(NodeBase*& head, size_type n, NodeBase* parent)
+	{
+		if (n == 0)
+			return NULL;
+		const size_type nLeft = n / 2;
+		NodeBase* left = buildTree(head, nLeft, NULL);
+		NodeBase* node = head;
+
+		head = head->right;
+		node->parent = parent;
+		node->left = left;
+		if (left)
+			left->parent = node;
+		node->right = buildTree(head, n - nLeft - 1, node);
+		node->updateHeight();
+		return node;
+	}
+
+	// Copies a subtree node for node, keeping its shape. The copies are
+	// threaded in order after last.
+	NodeBase* clone(const NodeBase* src, NodeBase* parent, NodeBase*& last)
+	{
+		NodeBase* node = createNode(static_cast<const Node*>(src)->value);
+
+		node->parent = parent;
+		node->height = src->height;
+		if (src->left)
+			node->left = clone(src->left, node, last);
+		static_cast<stats_type&>(*node) = static_cast<const stats_type&>(*src);
+		node->linkAfter(last);
+		last = node;
+		if (src->right)
+			node->right = clone(src->right, node, last);
+		return node;
+	}
+
+#ifdef FT_CXX11
+	struct CloneTask
+	{
+		const NodeBase*	src;
+		NodeBase*		parent;
+		NodeBase**		slot;
+	};
+	template <typename RandomIt>
+	struct BuildTask
+	{
+		RandomIt	first;
+		size_type	count;
+		NodeBase*	parent;
+		NodeBase**	slot;
+	};
+
+	// Depth of the cut of the parallel operations
+	static size_type cutDepth(const thread_pool& pool)
+	{
+		size_type depth = 0;
+		while ((size_type(1) << depth) < 8 * size_type(pool.size()))
+			depth++;
+		return depth;
+	}
+
+	// Collects the subtrees depth levels below node
+	static void cutTree(NodeBase* node, size_type depth, std::vector<NodeBase*>& cut)
+	{
+		if (!node)
+			return;
+		if (depth == 0)
+		{
+			cut.push_back(node);
+			return;
+		}
+		cutTree(node->left, depth - 1, cut);
+		cutTree(node->right, depth - 1, cut);
+	}
+
+	// Copies the nodes above the cut, the subtrees below are left as tasks
+	void cloneSpine(const NodeBase* src, NodeBase* parent, NodeBase** slot, size_type depth,
+		std::vector<CloneTask>& tasks)
+	{
+		if (depth == 0)
+		{
+			CloneTask task = { src, parent, slot };
+			tasks.push_back(task);
+			return;
+		}
+		NodeBase* node = createNode(static_cast<const Node*>(src)->value);
+
+		node->parent = parent;
+		node->height = src->height;
+		static_cast<stats_type&>(*node) = static_cast<const stats_type&>(*src);
+		*slot = node;
+		if (src->left)
+			cloneSpine(src->left, node, &node->left, depth - 1, tasks);
+		if (src->right)
+			cloneSpine(src->right, node, &node->right, depth - 1, tasks);
+	}
+	// Same as clone, leaving the thread to threadParallel
+	NodeBase* cloneShape(const NodeBase* src, NodeBase* parent)
+	{
+		NodeBase* node = createNode(static_cast<const Node*>(src)->value);
+
+		node->parent = parent;
+		node->height = src->height;
+		static_cast<stats_type&>(*node) = static_cast<const stats_type&>(*src);
+		if (src->left)
+			node->left = cloneShape(src->left, node);
+		if (src->right)
+			node->right = cloneShape(src->right, node);
+		return node;
+	}
+
+	// Builds the nodes above the cut, in the shape buildTree gives
+	template <typename RandomIt>
+	void buildSpine(RandomIt first, size_type n, NodeBase* parent, NodeBase** slot, size_type depth,
+		std::vector<BuildTask<RandomIt> >& tasks)
+	{
+		if (n == 0)
+			return;
+		if (depth == 0)
+		{
+			BuildTask<RandomIt> task = { first, n, parent, slot };
+			tasks.push_back(task);
+			return;
+		}
+		const size_type nLeft = n / 2;
+		NodeBase* node = createNode(first[nLeft]);
+
+		node->parent = parent;
+		*slot = node;
+		buildSpine(first, nLeft, node, &node->left, depth - 1, tasks);
+		buildSpine(first + nLeft + 1, n - nLeft - 1, node, &node->right, depth - 1, tasks);
+	}
+	template <typename RandomIt>
+	NodeBase* buildRange(RandomIt first, size_type n, NodeBase* parent)
+	{
+		if (n == 0)
+			return NULL;
+		const size_type nLeft = n / 2;
+		NodeBase* node = createNode(first[nLeft]);
+
+		node->parent = parent;
+		node->left = buildRange(first, nLeft, node);
+		node->right = buildRange(first + nLeft + 1, n - nLeft - 1, node);
+		node->updateHeight();
+		return node;
+	}
+	// Heights and stats of the nodes above the cut, once the subtrees are done
+	void updateSpine(NodeBase* node, size_type depth)
+	{
+		if (!node || depth == 0)
+			return;
+		updateSpine(node->left, depth - 1);
+		updateSpine(node->right, depth - 1);
+		node->updateHeight();
+	}
+
+	void deleteSpine(NodeBase* node, size_type depth)
+	{
+		if (!node || depth == 0)
+			return;
+		deleteSpine(node->left, depth - 1);
+		deleteSpine(node->right, depth - 1);
+		destroyNode(static_cast<Node*>(node));
+	}
+
+	template <typename Fn>
+	static void forEachNode(NodeBase* node, Fn& fn)
+	{
+		if (!node)
+			return;
+		forEachNode(node->left, fn);
+		fn(static_cast<Node*>(node)->value);
+		forEachNode(node->right, fn);
+	}
+	template <typename Fn>
+	static void forEachSpine(NodeBase* node, size_type depth, Fn& fn)
+	{
+		if (!node || depth == 0)
+			return;
+		forEachSpine(node->left, depth - 1, fn);
+		fn(static_cast<Node*>(node)->value);
+		forEachSpine(node->right, depth - 1, fn);
+	}
+
+	// Threads a tree built or copied in parallel. The nodes above the cut
+	// are threaded here, each subtree below it by a task starting from the
+	// node before it; the links written never overlap.
+	void threadParallel(size_type depth, thread_pool& pool)
+	{
+		if (!Threaded)
+			return;
+		std::vector<NodeBase*> cut;
+		std::vector<NodeBase*> before;
+		NodeBase* last = &_header;
+
+		threadSpine(root(), depth, last, cut, before);
+		last->threadTo(&_header);
+		pool.run(cut.size(), [&](std::size_t i)
+		{
+			NodeBase* last = before[i];
+			threadTree(cut[i], last);
+		});
+	}
+	void threadSpine(NodeBase* node, size_type depth, NodeBase*& last,
+		std::vector<NodeBase*>& cut, std::vector<NodeBase*>& before)
+	{
+		if (!node)
+			return;
+		if (depth == 0)
+		{
+			cut.push_back(node);
+			before.push_back(last);
+			last = biggest(node);
+			return;
+		}
+		threadSpine(node->left, depth - 1, last, cut, before);
+		last->threadTo(node);
+		last = node;
+		threadSpine(node->right, depth - 1, last, cut, before);
+	}
+	static void threadTree(NodeBase* node, NodeBase*& last)
+	{
+		if (!node)
+			return;
+		threadTree(node->left, last);
+		last->threadTo(node);
+		last = node;
+		threadTree(node->right, last);
+	}
+#endif
+
+	NodeBase* smallest(NodeBase* node) const
+	{
+		if (!node)
+			return NULL;
+		while (node->left)
+			node = node->left;
+		return node;
+	}
+	NodeBase* biggest(NodeBase* node) const
+	{
+		if (!node)
+			return NULL;
+		while (node->right)
+			node = node->right;
+		return node;
+	}
+
+	NodeBase* lower(const key_type& key) const
+	{
+		NodeBase* current = root();
+		NodeBase* res = header();
+
+		while (current)
+		{
+			if (_comp(key, this->key(current)))
+			{
+				res = current;
+				current = current->left;
+			}
+			else if (_comp(this->key(current), key))
+				current = current->right;
+			else
+				return current;
+		}
+		return res;
+	}
+	NodeBase* higher(const key_type& key) const
+	{
+		NodeBase* current = root();
+		NodeBase* res = header();
+
+		while (current)
+		{
+			if (_comp(key, this->key(current)))
+			{
+				res = current;
+				current = current->left;
+			}
+			else
+				current = current->right;
+		}
+		return res;
+	}
+
+	static size_type subtreeSize(const NodeBase* node) { return node ? node->count : 0; }
+
+	NodeBase* nthNode(size_type k) const
+	{
+		NodeBase* node = root();
+
+		if (k >= _size)
+			return header();
+		for (;;)
+		{
+			const size_type nLeft = subtreeSize(node->left);
+			if (k == nLeft)
+				return node;
+			if (k < nLeft)
+				node = node->left;
+			else
+			{
+				k -= nLeft + 1;
+				node = node->right;
+			}
+		}
+	}
+
+	// Aggregate of the keys of a subtree within the bounds, a NULL bound
+	// is unbounded. Once the walk splits, each side only has one bound
+	// left, so this follows at most two paths.
+	typename stats_type::aggregate_type aggregateRange(const NodeBase* node,
+		const key_type* lo, const key_type* hi) const
+	{
+		const Augment augment;
+
+		while (node)
+		{
+			if (!lo && !hi)
+				return node->aggregate;
+			if (lo && _comp(key(node), *lo))
+				node = node->right;
+			else if (hi && !_comp(key(node), *hi))
+				node = node->left;
+			else
+				return augment.combine(augment.combine(aggregateRange(node->left, lo, NULL),
+					augment.lift(static_cast<const Node*>(node)->value)),
+					aggregateRange(node->right, NULL, hi));
+		}
+		return augment.identity();
+	}
+
+	void replace(NodeBase* node, NodeBase* by)
+	{
+		NodeBase* parent = node->parent;
+
+		if (by)
+			by->parent = parent;
+		if (parent->isHeader())
+			_header.parent = by;
+		else
+			parent->replaceChild(node, by);
+	}
+
+	// Returns the number of nodes deleted
+	size_type deleteNodeAndChild(NodeBase *node, bool keep = false)
+	{
+		size_type n = 1;
+
+		if (node->left)
+			n += deleteNodeAndChild(node->left, keep);
+		if (node->right)
+			n += deleteNodeAndChild(node->right, keep);
+		destroyNode(static_cast<Node*>(node), keep);
+		return n;
+	}
+
+	void recount(NodeBase* from)
+	{
+		for (; !from->isHeader(); from = from->parent)
+			from->updateHeight();
+	}
+
+	void rebalance(NodeBase* from)
+	{
+		for (; !from->isHeader(); from = from->parent)
+		{
+			from->updateHeight();
+			if (from->isImbalanced())
+				from = rotate(from);
+		}
+	}
+
+	// After an insertion or a join the walk up can stop as soon as a
+	// subtree keeps its height. After an insertion, a rotation always
+	// restores the height it had before.
+	// Stats still have to be updated up to the root.
+	void rebalanceInsert(NodeBase* from)
+	{
+		for (; !from->isHeader(); from = from->parent)
+		{
+			const size_type height = from->height;
+			from->updateHeight();
+			if (from->isImbalanced())
+				from = rotate(from);
+			if (from->height == height)
+				break;
+		}
+		if (stats_type::enabled && !from->isHeader())
+			recount(from->parent);
+	}
+
+	static size_type heightOf(const NodeBase* node) { return node ? node->height : 0; }
+
+	// Hangs a tree under the header, first and last being its smallest and
+	// biggest nodes
+	void setRoot(NodeBase* node, NodeBase* first, NodeBase* last)
+	{
+		if (!node)
+		{
+			resetHeader();
+			return;
+		}
+		_header.parent = node;
+		node->parent = &_header;
+		_header.left = first;
+		_header.right = last;
+	}
+
+	// Number of elements from node on
+	size_type countFrom(NodeBase* node, internal::true_type) const
+	{
+		return _size - rank(key(node));
+	}
+	// Walks both sides of node at once, to stop at the end of the smaller
+	size_type countFrom(NodeBase* node, internal::false_type) const
+	{
+		NodeBase* forward = node;
+		NodeBase* backward = _header.left;
+
+		for (size_type n = 0;; n++)
+		{
+			if (forward->isHeader())
+				return n;
+			if (backward == node)
+				return _size - n;
+			forward = forward->nextNode();
+			backward = backward->nextNode();
+		}
+	}
+
+	// Splits a subtree into the keys below key and the others, by joining
+	// back the pieces hanging off the search path. The join heights add up
+	// to the height of the subtree, so this is O(log n). The thread and
+	// the header are left for the caller to fix.
+	void splitTree(NodeBase* node, const key_type& key, NodeBase*& left, NodeBase*& right)
+	{
+		if (!node)
+		{
+			left = NULL;
+			right = NULL;
+			return;
+		}
+		NodeBase* rest;
+
+		if (_comp(this->key(node), key))
+		{
+			splitTree(node->right, key, rest, right);
+			left = joinTrees(node->left, node, rest);
+		}
+		else
+		{
+			splitTree(node->left, key, left, rest);
+			right = joinTrees(rest, node, node->right);
+		}
+	}
+
+	// Joins two trees and a node with a key between theirs, in
+	// O(1 + height difference): the node takes the place of the subtree
+	// of the taller tree, along its inner side, that has about the height
+	// of the shorter one. The trees are rebalanced under the header, which
+	// is left pointing at the result.
+	NodeBase* joinTrees(NodeBase* left, NodeBase* mid, NodeBase* right)
+	{
+		const size_type hLeft = heightOf(left);
+		const size_type hRight = heightOf(right);
+		NodeBase* parent = header();
+		NodeBase* top = mid;
+
+		if (hLeft > hRight + 1)
+		{
+			top = left;
+			while (heightOf(left) > hRight + 1)
+			{
+				parent = left;
+				left = left->right;
+			}
+			parent->right = mid;
+		}
+		else if (hRight > hLeft + 1)
+		{
+			top = right;
+			while (heightOf(right) > hLeft + 1)
+			{
+				parent = right;
+				right = right->left;
+			}
+			parent->left = mid;
+		}
+		mid->left = left;
+		if (left)
+			left->parent = mid;
+		mid->right = right;
+		if (right)
+			right->parent = mid;
+		mid->parent = parent;
+		mid->updateHeight();
+
+		_header.parent = top;
+		top->parent = header();
+		rebalanceInsert(parent);
+		return root();
+	}
+	// Joins two trees, all the keys of left being below the ones of right,
+	// using the smallest node of right as the middle one
+	NodeBase* joinTrees(NodeBase* left, NodeBase* right)
+	{
+		if (!left || !right)
+			return left ? left : right;
+		NodeBase* mid = smallest(right);
+
+		_header.parent = right;
+		right->parent = header();
+		replace(mid, mid->right);
+		rebalance(mid->parent);
+		return joinTrees(left, mid, root());
+	}
+
+	NodeBase* rotate(NodeBase* from)
+	{
+		NodeBase* tmp;
+
+		if (from->rightHeight() > from->leftHeight())
+		{
+			tmp = from->right;
+			if (tmp->rightHeight() < tmp->leftHeight())
+				rotateRight(tmp);
+			return rotateLeft(from);
+		}
+		tmp = from->left;
+		if (tmp->rightHeight() > tmp->leftHeight())
+			rotateLeft(tmp);
+		return rotateRight(from);
+	}
+
+	NodeBase* rotateLeft(NodeBase* node)
+	{
+		NodeBase* newNode = node->right;
+		NodeBase* tmp = newNode->left;
+		NodeBase* parent = node->parent;
+
+		node->right = tmp;
+		if (tmp)
+			tmp->parent = node;
 		newNode->parent = node->parent;
 		node->parent = newNode;
 		newNode->left = node;
@@ -650,18 +1902,18 @@ private:
 		node->updateHeight();
 		newNode->updateHeight();
 
-		if(!parent)
-			_root = newNode;
+		if (parent->isHeader())
+			_header.parent = newNode;
 		else
 			parent->replaceChild(node, newNode);
 		return newNode;
 	}
 
-	Node* rotateRight(Node* node)
+	NodeBase* rotateRight(NodeBase* node)
 	{
-		Node* newNode = node->left;
-		Node* tmp = newNode->right;
-		Node* parent = node->parent;
+		NodeBase* newNode = node->left;
+		NodeBase* tmp = newNode->right;
+		NodeBase* parent = node->parent;
 
 		node->left = tmp;
 		if (tmp)
@@ -673,58 +1925,214 @@ private:
 		node->updateHeight();
 		newNode->updateHeight();
 
-		if(!parent)
-			_root = newNode;
+		if (parent->isHeader())
+			_header.parent = newNode;
 		else
 			parent->replaceChild(node, newNode);
 		return newNode;
 	}
 
 private:
-	Node*			_root;
+	NodeBase		_header;
+	Node*			_spare;
 	size_type		_size;
 	key_compare		_comp;
 	allocator_type	_alloc;
+	node_allocator	_node_alloc;
 };
 
-template< class Key, class T, class Compare, class Alloc >
-bool operator==(const map<Key, T, Compare, Alloc>& a, const map<Key, T, Compare, Alloc>& b)
+template< class Key, class T, class Compare, class Alloc, bool Threaded, class Augment >
+bool operator==(const map<Key, T, Compare, Alloc, Threaded, Augment>& a,
+	const map<Key, T, Compare, Alloc, Threaded, Augment>& b)
 {
 	if (a.size() != b.size())
 		return false;
 	return ft::equal(a.begin(), a.end(), b.begin());
 }
 
-template< class Key, class T, class Compare, class Alloc >
-bool operator!=(const map<Key, T, Compare, Alloc>& a, const map<Key, T, Compare, Alloc>& b)
+template< class Key, class T, class Compare, class Alloc, bool Threaded, class Augment >
+bool operator!=(const map<Key, T, Compare, Alloc, Threaded, Augment>& a,
+	const map<Key, T, Compare, Alloc, Threaded, Augment>& b)
 {
 	return !(a == b);
 }
 
-template< class Key, class T, class Compare, class Alloc >
-bool operator<(const map<Key, T, Compare, Alloc>& a, const map<Key, T, Compare, Alloc>& b)
+template< class Key, class T, class Compare, class Alloc, bool Threaded, class Augment >
+bool operator<(const map<Key, T, Compare, Alloc, Threaded, Augment>& a,
+	const map<Key, T, Compare, Alloc, Threaded, Augment>& b)
 {
 	return ft::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end());
 }
 
-template< class Key, class T, class Compare, class Alloc >
-bool operator>(const map<Key, T, Compare, Alloc>& a, const map<Key, T, Compare, Alloc>& b)
+template< class Key, class T, class Compare, class Alloc, bool Threaded, class Augment >
+bool operator>(const map<Key, T, Compare, Alloc, Threaded, Augment>& a,
+	const map<Key, T, Compare, Alloc, Threaded, Augment>& b)
 {
 	return (b < a);
 }
 
-template< class Key, class T, class Compare, class Alloc >
-bool operator<=(const map<Key, T, Compare, Alloc>& a, const map<Key, T, Compare, Alloc>& b)
+template< class Key, class T, class Compare, class Alloc, bool Threaded, class Augment >
+bool operator<=(const map<Key, T, Compare, Alloc, Threaded, Augment>& a,
+	const map<Key, T, Compare, Alloc, Threaded, Augment>& b)
 {
 	return !(a > b);
 }
 
-template< class Key, class T, class Compare, class Alloc >
-bool operator>=(const map<Key, T, Compare, Alloc>& a, const map<Key, T, Compare, Alloc>& b)
+template< class Key, class T, class Compare, class Alloc, bool Threaded, class Augment >
+bool operator>=(const map<Key, T, Compare, Alloc, Threaded, Augment>& a,
+	const map<Key, T, Compare, Alloc, Threaded, Augment>& b)
 {
 	return !(a < b);
 }
 
+#ifdef FT_CXX11
+// Calls fn on every element of m from the threads of pool, see map
+template< class Key, class T, class Compare, class Alloc, bool Threaded, class Augment, class Fn >
+void parallel_for_each(map<Key, T, Compare, Alloc, Threaded, Augment>& m, Fn fn, thread_pool& pool)
+{
+	m.parallel_for_each(fn, pool);
+}
+#endif
+
+namespace internal
+{
+
+enum set_operation
+{
+	set_union,
+	set_intersection,
+	set_difference
+};
+
+// Input iterator over the union, intersection or difference of two
+// ranges of pairs sorted by key. Elements of the first range win when a
+// key is in both.
+template <typename It, typename Compare, set_operation Op>
+class set_operation_iterator
+{
+public:
+	typedef typename ft::iterator_traits<It>::value_type		value_type;
+	typedef typename ft::iterator_traits<It>::difference_type	difference_type;
+	typedef typename ft::iterator_traits<It>::pointer			pointer;
+	typedef typename ft::iterator_traits<It>::reference			reference;
+	typedef ft::input_iterator_tag								iterator_category;
+
+	set_operation_iterator(It first1, It last1, It first2, It last2, const Compare& comp) :
+		_it1(first1),
+		_last1(last1),
+		_it2(first2),
+		_last2(last2),
+		_comp(comp)
+	{
+		settle();
+	}
+
+	reference operator*() const { return fromSecond() ? *_it2 : *_it1; }
+
+	set_operation_iterator& operator++()
+	{
+		if (fromSecond())
+			++_it2;
+		else
+		{
+			if (_it2 != _last2 && !_comp((*_it1).first, (*_it2).first))
+				++_it2;
+			++_it1;
+		}
+		settle();
+		return *this;
+	}
+
+	bool operator==(const set_operation_iterator& other) const
+	{
+		return _it1 == other._it1 && _it2 == other._it2;
+	}
+	bool operator!=(const set_operation_iterator& other) const { return !(*this == other); }
+
+private:
+	bool fromSecond() const
+	{
+		return Op == set_union && _it2 != _last2
+			&& (_it1 == _last1 || _comp((*_it2).first, (*_it1).first));
+	}
+
+	// Skips to the next element of the result. Once it has no more
+	// elements, both iterators are at the end of their range.
+	void settle()
+	{
+		if (Op == set_union)
+			return;
+		while (_it1 != _last1 && _it2 != _last2)
+		{
+			if (_comp((*_it1).first, (*_it2).first))
+			{
+				if (Op == set_difference)
+					return;
+				++_it1;
+			}
+			else if (_comp((*_it2).first, (*_it1).first))
+				++_it2;
+			else if (Op == set_intersection)
+				return;
+			else
+			{
+				++_it1;
+				++_it2;
+			}
+		}
+		if (Op == set_intersection)
+			_it1 = _last1;
+		if (_it1 == _last1)
+			_it2 = _last2;
+	}
+
+	It		_it1;
+	It		_last1;
+	It		_it2;
+	It		_last2;
+	Compare	_comp;
+};
+
+template <set_operation Op, class Key, class T, class Compare, class Alloc, bool Threaded, class Augment>
+map<Key, T, Compare, Alloc, Threaded, Augment> map_set_operation(
+	const map<Key, T, Compare, Alloc, Threaded, Augment>& a,
+	const map<Key, T, Compare, Alloc, Threaded, Augment>& b)
+{
+	typedef typename map<Key, T, Compare, Alloc, Threaded, Augment>::const_iterator	iterator;
+	typedef set_operation_iterator<iterator, Compare, Op>	op_iterator;
+
+	return map<Key, T, Compare, Alloc, Threaded, Augment>(from_sorted,
+		op_iterator(a.begin(), a.end(), b.begin(), b.end(), a.key_comp()),
+		op_iterator(a.end(), a.end(), b.end(), b.end(), a.key_comp()),
+		a.key_comp(), a.get_allocator());
+}
+
+} //internal
+
+// Set operations on the keys of two maps ordered the same way, in one
+// linear merge feeding an O(n) build. Where a key is in both maps, the
+// element of a is kept.
+template< class Key, class T, class Compare, class Alloc, bool Threaded, class Augment >
+map<Key, T, Compare, Alloc, Threaded, Augment> map_union(const map<Key, T, Compare, Alloc, Threaded, Augment>& a,
+	const map<Key, T, Compare, Alloc, Threaded, Augment>& b)
+{
+	return internal::map_set_operation<internal::set_union>(a, b);
+}
+
+template< class Key, class T, class Compare, class Alloc, bool Threaded, class Augment >
+map<Key, T, Compare, Alloc, Threaded, Augment> map_intersection(const map<Key, T, Compare, Alloc, Threaded, Augment>& a,
+	const map<Key, T, Compare, Alloc, Threaded, Augment>& b)
+{
+	return internal::map_set_operation<internal::set_intersection>(a, b);
+}
+
+template< class Key, class T, class Compare, class Alloc, bool Threaded, class Augment >
+map<Key, T, Compare, Alloc, Threaded, Augment> map_difference(const map<Key, T, Compare, Alloc, Threaded, Augment>& a,
+	const map<Key, T, Compare, Alloc, Threaded, Augment>& b)
+{
+	return internal::map_set_operation<internal::set_difference>(a, b);
+}
+
 } //ft
 
 #endif // MAP_HPP
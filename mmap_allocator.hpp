@@ -0,0 +1,162 @@
+#ifndef MMAP_ALLOCATOR_HPP
+#define MMAP_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <new>
+#include <sys/mman.h>
+#include <unistd.h>
+#include "utils.hpp"
+
+namespace ft
+{
+
+enum mmap_flags
+{
+	mmap_default = 0,
+	// Ask the kernel to back the mapping with transparent huge pages
+	mmap_huge_pages = 1,
+	// Map from the reserved hugetlbfs pool, falling back to normal pages
+	mmap_hugetlb = 2
+};
+
+// Allocator mapping every block directly with mmap. Meant for very large
+// vectors: blocks are page granular, and they can be grown with mremap
+// instead of being copied (see has_reallocate).
+template<typename T>
+class mmap_allocator
+{
+public:
+	typedef T			value_type;
+	typedef T*			pointer;
+	typedef const T*	const_pointer;
+	typedef T&			reference;
+	typedef const T&	const_reference;
+	typedef std::size_t	size_type;
+	typedef ptrdiff_t	difference_type;
+
+	template<typename U>
+	struct rebind {
+		typedef mmap_allocator<U> other;
+	};
+
+	static const size_type huge_page_size = 2 * 1024 * 1024;
+
+	mmap_allocator(int flags = mmap_default) : _flags(flags) {}
+	mmap_allocator(const mmap_allocator& other) : _flags(other._flags) {}
+	template<typename U>
+	mmap_allocator(const mmap_allocator<U>& other) : _flags(other.flags()) {}
+	~mmap_allocator() {}
+
+	mmap_allocator& operator=(const mmap_allocator& other)
+	{
+		_flags = other._flags;
+		return *this;
+	}
+
+	pointer allocate(size_type n, const void* hint = NULL)
+	{
+		(void)hint;
+		if (n == 0)
+			return NULL;
+		if (n > max_size())
+			throw std::bad_alloc();
+		const size_type len = length(n);
+		void* p = MAP_FAILED;
+#ifdef MAP_HUGETLB
+		if (_flags & mmap_hugetlb)
+			p = mmap(NULL, len, PROT_READ | PROT_WRITE,
+					 MAP_PRIVATE | MAP_ANONYMOUS | MAP_HUGETLB, -1, 0);
+#endif
+		if (p == MAP_FAILED)
+			p = mmap(NULL, len, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANONYMOUS, -1, 0);
+		if (p == MAP_FAILED)
+			throw std::bad_alloc();
+		advise(p, len);
+		return static_cast<pointer>(p);
+	}
+
+	void deallocate(pointer p, size_type n)
+	{
+		if (p)
+			munmap(p, length(n));
+	}
+
+	// Resizes a block from old_n to new_n elements, possibly moving it by
+	// remapping its pages. Returns NULL when the block could not be
+	// remapped, in which case it is left untouched.
+	pointer reallocate(pointer p, size_type old_n, size_type new_n)
+	{
+#ifdef MREMAP_MAYMOVE
+		if (!p || new_n == 0 || new_n > max_size())
+			return NULL;
+		const size_type len = length(new_n);
+		void* res = mremap(p, length(old_n), len, MREMAP_MAYMOVE);
+		if (res == MAP_FAILED)
+			return NULL;
+		advise(res, len);
+		return static_cast<pointer>(res);
+#else
+		(void)p;
+		(void)old_n;
+		(void)new_n;
+		return NULL;
+#endif
+	}
+
+	void construct(pointer p, const T& value) { new(static_cast<void*>(p)) T(value); }
+#ifdef FT_CXX11
+	template<typename U, typename... Args>
+	void construct(U* p, Args&&... args) { new(static_cast<void*>(p)) U(std::forward<Args>(args)...); }
+#endif
+	void destroy(pointer p) { p->~T(); }
+
+	pointer address(reference x) const { return &x; }
+	const_pointer address(const_reference x) const { return &x; }
+	size_type max_size() const { return (size_type(-1) - huge_page_size) / sizeof(T); }
+
+	int flags() const { return _flags; }
+
+private:
+	size_type length(size_type n) const
+	{
+		const size_type page = (_flags & mmap_hugetlb) ? huge_page_size : page_size();
+		return (n * sizeof(T) + page - 1) / page * page;
+	}
+
+	static size_type page_size()
+	{
+		static const size_type size = sysconf(_SC_PAGESIZE);
+		return size;
+	}
+
+	void advise(void* p, size_type len) const
+	{
+#ifdef MADV_HUGEPAGE
+		if (_flags & mmap_huge_pages)
+			madvise(p, len, MADV_HUGEPAGE);
+#else
+		(void)p;
+		(void)len;
+#endif
+	}
+
+	int _flags;
+};
+
+template<typename T, typename U>
+bool operator==(const mmap_allocator<T>& a, const mmap_allocator<U>& b)
+{
+	return a.flags() == b.flags();
+}
+
+template<typename T, typename U>
+bool operator!=(const mmap_allocator<T>& a, const mmap_allocator<U>& b)
+{
+	return !(a == b);
+}
+
+template<typename T> struct has_reallocate<mmap_allocator<T> > : public internal::true_type {};
+
+} //ft
+
+#endif // MMAP_ALLOCATOR_HPP
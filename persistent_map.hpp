@@ -0,0 +1,598 @@
+#ifndef PERSISTENT_MAP_HPP
+#define PERSISTENT_MAP_HPP
+
+#include <cstddef>
+#include <memory>
+#include <stdexcept>
+#include "iterator.hpp"
+#include "utils.hpp"
+#include "compare.hpp"
+#include "map.hpp"
+
+namespace ft
+{
+
+// AVL map whose copies share their nodes. Nodes are reference counted
+// and a version only writes to the nodes it holds alone: insert and erase
+// copy the shared ones on the way from the root to the change, O(log n)
+// of them, and leave the other versions untouched. Copying the map, or
+// taking a snapshot(), is O(1). Without snapshots alive nothing is copied
+// and it behaves as a plain AVL tree.
+// Elements are only reachable as const, insert_or_assign changes values.
+// Versions sharing nodes may be used from different threads, a single
+// version is not thread safe. Iterators are invalidated by any change of
+// the version they come from, while those of a snapshot stay valid.
+template <typename Key, typename T, typename Compare = ft::less<Key>,
+	typename Allocator = std::allocator<ft::pair<const Key, T> > >
+class persistent_map
+{
+private:
+	struct Node;
+
+	// Past this height an AVL tree holds more than 10^13 elements
+	enum { max_height = 64 };
+	typedef internal::alloc_traits<Allocator>	alloc_traits;
+
+public:
+	typedef Allocator									allocator_type;
+	typedef typename alloc_traits::value_type			value_type;
+	typedef Compare										key_compare;
+	typedef map_value_compare<Key, T, key_compare>		value_compare;
+	typedef Key											key_type;
+	typedef T											data_type;
+	typedef T											mapped_type;
+	typedef typename alloc_traits::pointer				pointer;
+	typedef typename alloc_traits::const_pointer		const_pointer;
+	typedef typename alloc_traits::reference			reference;
+	typedef typename alloc_traits::const_reference		const_reference;
+	typedef typename alloc_traits::size_type			size_type;
+	typedef typename alloc_traits::difference_type		difference_type;
+	typedef typename alloc_traits::template rebind<Node>::other	node_allocator;
+
+	// Nodes have no parent link, as they may have several, so iterators
+	// keep the path from the root to their node
+	class PersistentIterator
+	{
+	public:
+		typedef const typename alloc_traits::value_type	value_type;
+		typedef value_type*								pointer;
+		typedef value_type&								reference;
+		typedef ft::bidirectional_iterator_tag			iterator_category;
+		typedef typename alloc_traits::difference_type	difference_type;
+
+		PersistentIterator() :
+			_root(NULL),
+			_depth(0)
+		{}
+		PersistentIterator(const PersistentIterator& other) :
+			_root(other._root),
+			_depth(other._depth)
+		{
+			for (unsigned int i = 0; i < _depth; i++)
+				_path[i] = other._path[i];
+		}
+		PersistentIterator& operator=(const PersistentIterator& other)
+		{
+			_root = other._root;
+			_depth = other._depth;
+			for (unsigned int i = 0; i < _depth; i++)
+				_path[i] = other._path[i];
+			return *this;
+		}
+
+		reference operator*() const { return _path[_depth - 1]->value; }
+		pointer operator->() const { return &operator*(); }
+
+		PersistentIterator& operator++()
+		{
+			Node* node = _path[_depth - 1];
+			if (node->right)
+				pushEdge(node->right, false);
+			else
+			{
+				do
+					node = _path[--_depth];
+				while (_depth && _path[_depth - 1]->right == node);
+			}
+			return *this;
+		}
+		PersistentIterator operator++(int)
+		{
+			PersistentIterator tmp = *this;
+			++*this;
+			return tmp;
+		}
+
+		// end() leads to the biggest element
+		PersistentIterator& operator--()
+		{
+			if (!_depth)
+				pushEdge(_root, true);
+			else if (_path[_depth - 1]->left)
+				pushEdge(_path[_depth - 1]->left, true);
+			else
+			{
+				Node* node;
+				do
+					node = _path[--_depth];
+				while (_depth && _path[_depth - 1]->left == node);
+			}
+			return *this;
+		}
+		PersistentIterator operator--(int)
+		{
+			PersistentIterator tmp = *this;
+			--*this;
+			return tmp;
+		}
+
+		bool operator==(const PersistentIterator& other) const { return node() == other.node(); }
+		bool operator!=(const PersistentIterator& other) const { return node() != other.node(); }
+
+	private:
+		friend class persistent_map;
+
+		explicit PersistentIterator(Node* root) :
+			_root(root),
+			_depth(0)
+		{}
+
+		Node* node() const { return _depth ? _path[_depth - 1] : NULL; }
+		void push(Node* node) { _path[_depth++] = node; }
+		// Pushes node then its children on one side, down to the last one
+		void pushEdge(Node* node, bool right)
+		{
+			for (; node; node = right ? node->right : node->left)
+				push(node);
+		}
+
+		Node*			_root;
+		unsigned int	_depth;
+		Node*			_path[max_height];
+	};
+
+	typedef PersistentIterator						iterator;
+	typedef PersistentIterator						const_iterator;
+	typedef ft::reverse_iterator<iterator>			reverse_iterator;
+	typedef ft::reverse_iterator<const_iterator>	const_reverse_iterator;
+
+	//constructors
+	persistent_map() :
+		_root(NULL),
+		_size(0),
+		_comp(Compare()),
+		_alloc(Allocator()),
+		_node_alloc(_alloc)
+	{}
+	explicit persistent_map(const key_compare& comp, const allocator_type& alloc = allocator_type()) :
+		_root(NULL),
+		_size(0),
+		_comp(comp),
+		_alloc(alloc),
+		_node_alloc(_alloc)
+	{}
+	template <typename InputIt>
+	persistent_map(InputIt first, InputIt last, const key_compare& comp = key_compare(),
+		const allocator_type& alloc = allocator_type(),
+	typename ft::enable_if<!ft::is_integral<InputIt>::value, InputIt>::type* = NULL) :
+		_root(NULL),
+		_size(0),
+		_comp(comp),
+		_alloc(alloc),
+		_node_alloc(_alloc)
+	{
+		insert(first, last);
+	}
+	// Shares the nodes of other, O(1)
+	persistent_map(const persistent_map& other) :
+		_root(retain(other._root)),
+		_size(other._size),
+		_comp(other._comp),
+		_alloc(other._alloc),
+		_node_alloc(other._node_alloc)
+	{}
+	~persistent_map() { release(_root); }
+
+	persistent_map& operator=(const persistent_map& other)
+	{
+		retain(other._root);
+		release(_root);
+		_root = other._root;
+		_size = other._size;
+		_comp = other._comp;
+		_alloc = other._alloc;
+		_node_alloc = other._node_alloc;
+		return *this;
+	}
+
+	// The current version, which later changes of this map leave as is
+	persistent_map snapshot() const { return *this; }
+
+	allocator_type get_allocator() const { return _alloc; }
+
+	//element access
+	const T& at(const key_type& key) const
+	{
+		const_iterator it = find(key);
+		if (it == end())
+			throw std::out_of_range("persistent_map::at");
+		return (*it).second;
+	}
+
+	//iterators
+	const_iterator begin() const
+	{
+		const_iterator it(_root);
+		it.pushEdge(_root, false);
+		return it;
+	}
+	const_iterator end() const { return const_iterator(_root); }
+
+	const_reverse_iterator rbegin() const { return const_reverse_iterator(end()); }
+	const_reverse_iterator rend() const { return const_reverse_iterator(begin()); }
+
+	//capacity
+	bool empty() const { return _size == 0; }
+	size_type size() const { return _size; }
+	size_type max_size() const { return internal::alloc_traits<node_allocator>::max_size(_node_alloc); }
+
+	//modifiers
+	ft::pair<iterator, bool> insert(const value_type& value)
+	{
+		if (count(value.first))
+			return ft::make_pair(find(value.first), false);
+		Node** links[max_height];
+		unsigned int depth;
+		Node** link = ownPath(value.first, links, depth);
+		*link = createNode(value);
+		_size++;
+		rebalancePath(links, depth);
+		return ft::make_pair(find(value.first), true);
+	}
+	template <typename InputIt>
+	void insert(InputIt first, InputIt last)
+	{
+		for (; first != last; ++first)
+			insert(*first);
+	}
+
+	ft::pair<iterator, bool> insert_or_assign(const key_type& key, const mapped_type& value)
+	{
+		Node** links[max_height];
+		unsigned int depth;
+		Node** link = ownPath(key, links, depth);
+		if (*link)
+		{
+			(*link)->value.second = value;
+			return ft::make_pair(find(key), false);
+		}
+		*link = createNode(value_type(key, value));
+		_size++;
+		rebalancePath(links, depth);
+		return ft::make_pair(find(key), true);
+	}
+
+	void erase(iterator position) { erase((*position).first); }
+	size_type erase(const key_type& key)
+	{
+		if (!count(key))
+			return 0;
+		Node** links[max_height];
+		unsigned int depth;
+		Node** link = ownPath(key, links, depth);
+		Node* node = *link;
+		const unsigned int at = depth - 1;
+		Node** minLink = NULL;
+		if (node->left && node->right)
+		{
+			minLink = &node->right;
+			for (;;)
+			{
+				*minLink = unique(*minLink);
+				links[depth++] = minLink;
+				if (!(*minLink)->left)
+					break;
+				minLink = &(*minLink)->left;
+			}
+		}
+
+		// Nothing allocates from here on but the rotations, and the
+		// element is gone before them
+		_size--;
+		depth--;
+		if (!minLink)
+			*link = node->left ? node->left : node->right;
+		else
+		{
+			Node* min = *minLink;
+			*minLink = min->right;
+			min->left = node->left;
+			min->right = node->right;
+			min->height = node->height;
+			*link = min;
+			if (depth > at + 1)
+				links[at + 1] = &min->right;
+		}
+		node->left = NULL;
+		node->right = NULL;
+		release(node);
+		rebalancePath(links, depth);
+		return 1;
+	}
+
+	void clear()
+	{
+		release(_root);
+		_root = NULL;
+		_size = 0;
+	}
+
+	void swap(persistent_map& other)
+	{
+		ft::swap(_root, other._root);
+		ft::swap(_size, other._size);
+		ft::swap(_comp, other._comp);
+		ft::swap(_alloc, other._alloc);
+		ft::swap(_node_alloc, other._node_alloc);
+	}
+
+	//lookup
+	size_type count(const key_type& key) const
+	{
+		Node* node = _root;
+		while (node)
+		{
+			if (_comp(key, node->value.first))
+				node = node->left;
+			else if (_comp(node->value.first, key))
+				node = node->right;
+			else
+				return 1;
+		}
+		return 0;
+	}
+	const_iterator find(const key_type& key) const
+	{
+		const_iterator it = lower_bound(key);
+		if (it != end() && _comp(key, (*it).first))
+			return end();
+		return it;
+	}
+	ft::pair<const_iterator, const_iterator> equal_range(const key_type& key) const {
+		return ft::make_pair(lower_bound(key), upper_bound(key));
+	}
+	const_iterator lower_bound(const key_type& key) const { return bound(key, false); }
+	const_iterator upper_bound(const key_type& key) const { return bound(key, true); }
+
+	//observers
+	key_compare key_comp() const { return _comp; }
+	value_compare value_comp() const { return value_compare(_comp); }
+
+private:
+	struct Node
+	{
+		Node*			left;
+		Node*			right;
+		std::size_t		refs;
+		unsigned char	height;
+		value_type		value;
+	};
+
+	static unsigned char heightOf(const Node* node) { return node ? node->height : 0; }
+	static void updateHeight(Node* node)
+	{
+		const unsigned char left = heightOf(node->left);
+		const unsigned char right = heightOf(node->right);
+		node->height = (left > right ? left : right) + 1;
+	}
+
+	static Node* retain(Node* node)
+	{
+		if (node)
+			internal::ref_acquire(node->refs);
+		return node;
+	}
+
+	void release(Node* node)
+	{
+		while (node && internal::ref_release(node->refs))
+		{
+			release(node->left);
+			Node* right = node->right;
+			alloc_traits::destroy(_alloc, &node->value);
+			_node_alloc.deallocate(node, 1);
+			node = right;
+		}
+	}
+
+	Node* createNode(const value_type& value)
+	{
+		Node* node = _node_alloc.allocate(1);
+		try
+		{
+			alloc_traits::construct(_alloc, &node->value, value);
+		}
+		catch (...)
+		{
+			_node_alloc.deallocate(node, 1);
+			throw;
+		}
+		node->left = NULL;
+		node->right = NULL;
+		node->refs = 1;
+		node->height = 1;
+		return node;
+	}
+
+	// Node when this version is its only holder, or else a copy of it
+	// that takes over the reference to node
+	Node* unique(Node* node)
+	{
+		if (internal::ref_count(node->refs) == 1)
+			return node;
+		Node* copy = createNode(node->value);
+		copy->left = retain(node->left);
+		copy->right = retain(node->right);
+		copy->height = node->height;
+		release(node);
+		return copy;
+	}
+
+	// Makes the nodes from the root to key unique to this version, and
+	// stores the links leading to them in links. Returns the link that
+	// holds key, or where it belongs.
+	// A copy that throws leaves the tree as it was, with some of its
+	// nodes unshared.
+	Node** ownPath(const key_type& key, Node*** links, unsigned int& depth)
+	{
+		Node** link = &_root;
+		depth = 0;
+		while (*link)
+		{
+			*link = unique(*link);
+			links[depth++] = link;
+			Node* node = *link;
+			if (_comp(key, node->value.first))
+				link = &node->left;
+			else if (_comp(node->value.first, key))
+				link = &node->right;
+			else
+				break;
+		}
+		return link;
+	}
+
+	// Rebalances the links of a path after a change at its end, stopping
+	// where a subtree keeps its height
+	void rebalancePath(Node*** links, unsigned int depth)
+	{
+		while (depth--)
+		{
+			Node*& link = *links[depth];
+			const unsigned char height = link->height;
+			rebalance(link);
+			if (link->height == height)
+				break;
+		}
+	}
+
+	void rebalance(Node*& link)
+	{
+		Node* node = link;
+		updateHeight(node);
+		const int balance = heightOf(node->left) - heightOf(node->right);
+		if (balance > 1)
+		{
+			if (heightOf(node->left->left) < heightOf(node->left->right))
+				rotateLeft(node->left);
+			rotateRight(link);
+		}
+		else if (balance < -1)
+		{
+			if (heightOf(node->right->right) < heightOf(node->right->left))
+				rotateRight(node->right);
+			rotateLeft(link);
+		}
+	}
+
+	// Both nodes that move are made unique first
+	void rotateLeft(Node*& link)
+	{
+		link = unique(link);
+		Node* node = link;
+		node->right = unique(node->right);
+		Node* newNode = node->right;
+		node->right = newNode->left;
+		newNode->left = node;
+		updateHeight(node);
+		updateHeight(newNode);
+		link = newNode;
+	}
+
+	void rotateRight(Node*& link)
+	{
+		link = unique(link);
+		Node* node = link;
+		node->left = unique(node->left);
+		Node* newNode = node->left;
+		node->left = newNode->right;
+		newNode->right = node;
+		updateHeight(node);
+		updateHeight(newNode);
+		link = newNode;
+	}
+
+	// The first element above key, or not below it
+	const_iterator bound(const key_type& key, bool upper) const
+	{
+		const_iterator it(_root);
+		unsigned int depth = 0;
+		for (Node* node = _root; node;)
+		{
+			it.push(node);
+			if (upper ? _comp(key, node->value.first) : !_comp(node->value.first, key))
+			{
+				depth = it._depth;
+				node = node->left;
+			}
+			else
+				node = node->right;
+		}
+		it._depth = depth;
+		return it;
+	}
+
+	Node*			_root;
+	size_type		_size;
+	key_compare		_comp;
+	allocator_type	_alloc;
+	node_allocator	_node_alloc;
+};
+
+template< class Key, class T, class Compare, class Alloc >
+bool operator==(const persistent_map<Key, T, Compare, Alloc>& a,
+	const persistent_map<Key, T, Compare, Alloc>& b)
+{
+	if (a.size() != b.size())
+		return false;
+	return ft::equal(a.begin(), a.end(), b.begin());
+}
+
+template< class Key, class T, class Compare, class Alloc >
+bool operator!=(const persistent_map<Key, T, Compare, Alloc>& a,
+	const persistent_map<Key, T, Compare, Alloc>& b)
+{
+	return !(a == b);
+}
+
+template< class Key, class T, class Compare, class Alloc >
+bool operator<(const persistent_map<Key, T, Compare, Alloc>& a,
+	const persistent_map<Key, T, Compare, Alloc>& b)
+{
+	return ft::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end());
+}
+
+template< class Key, class T, class Compare, class Alloc >
+bool operator>(const persistent_map<Key, T, Compare, Alloc>& a,
+	const persistent_map<Key, T, Compare, Alloc>& b)
+{
+	return (b < a);
+}
+
+template< class Key, class T, class Compare, class Alloc >
+bool operator<=(const persistent_map<Key, T, Compare, Alloc>& a,
+	const persistent_map<Key, T, Compare, Alloc>& b)
+{
+	return !(a > b);
+}
+
+template< class Key, class T, class Compare, class Alloc >
+bool operator>=(const persistent_map<Key, T, Compare, Alloc>& a,
+	const persistent_map<Key, T, Compare, Alloc>& b)
+{
+	return !(a < b);
+}
+
+} //ft
+
+#endif // PERSISTENT_MAP_HPP
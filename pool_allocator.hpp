@@ -0,0 +1,269 @@
+#ifndef POOL_ALLOCATOR_HPP
+#define POOL_ALLOCATOR_HPP
+
+#include <cstddef>
+#include <new>
+#include "utils.hpp"
+
+namespace ft
+{
+
+// Fixed size slots carved out of large blocks. Freed slots go on a free
+// list and are handed out again first, so churn never reaches malloc and
+// recently used slots stay close together.
+class node_pool
+{
+public:
+	static const std::size_t default_block_size = 64 * 1024;
+
+	explicit node_pool(std::size_t slot_size, std::size_t block_size = default_block_size) :
+		_slot_size(round_up(ft::max(slot_size, sizeof(free_slot)))),
+		_block_size(ft::max(block_size, sizeof(block) + _slot_size)),
+		_blocks(NULL),
+		_free(NULL),
+		_cur(NULL),
+		_end(NULL)
+	{
+	}
+	~node_pool()
+	{
+		while (_blocks)
+		{
+			block* next = _blocks->next;
+			::operator delete(_blocks);
+			_blocks = next;
+		}
+	}
+
+	void* allocate()
+	{
+		if (_free)
+		{
+			free_slot* slot = _free;
+			_free = slot->next;
+			return slot;
+		}
+		if (!_cur || _cur + _slot_size > _end)
+			grow();
+		void* p = _cur;
+		_cur += _slot_size;
+		return p;
+	}
+
+	void deallocate(void* p)
+	{
+		free_slot* slot = static_cast<free_slot*>(p);
+		slot->next = _free;
+		_free = slot;
+	}
+
+	std::size_t slot_size() const { return _slot_size; }
+
+private:
+	struct free_slot
+	{
+		free_slot* next;
+	};
+	struct block
+	{
+		block*				next;
+		internal::max_align	pad;
+	};
+
+	node_pool(const node_pool&);
+	node_pool& operator=(const node_pool&);
+
+	static std::size_t round_up(std::size_t size)
+	{
+		const std::size_t align = sizeof(internal::max_align);
+		return (size + align - 1) / align * align;
+	}
+
+	void grow()
+	{
+		block* b = static_cast<block*>(::operator new(_block_size));
+		b->next = _blocks;
+		_blocks = b;
+		_cur = reinterpret_cast<char*>(b + 1);
+		_end = reinterpret_cast<char*>(b) + _block_size;
+	}
+
+	std::size_t	_slot_size;
+	std::size_t	_block_size;
+	block*		_blocks;
+	free_slot*	_free;
+	char*		_cur;
+	char*		_end;
+};
+
+namespace internal {
+
+// The pools of a pool_allocator, its copies and its rebinds, one per
+// slot size
+class pool_set
+{
+public:
+	pool_set() : refs(1), _pools(NULL) {}
+	~pool_set()
+	{
+		while (_pools)
+		{
+			entry* next = _pools->next;
+			delete _pools;
+			_pools = next;
+		}
+	}
+
+	node_pool* get(std::size_t slot_size)
+	{
+		for (entry* e = _pools; e; e = e->next)
+			if (e->slot_size == slot_size)
+				return &e->pool;
+		_pools = new entry(slot_size, _pools);
+		return &_pools->pool;
+	}
+
+	std::size_t	refs;
+
+private:
+	struct entry
+	{
+		entry(std::size_t slot_size, entry* next) :
+			slot_size(slot_size),
+			pool(slot_size),
+			next(next)
+		{}
+
+		std::size_t	slot_size;
+		node_pool	pool;
+		entry*		next;
+	};
+
+	pool_set(const pool_set&);
+	pool_set& operator=(const pool_set&);
+
+	entry*	_pools;
+};
+
+} //internal
+
+// Allocator serving single objects from node_pools shared by all its
+// copies and rebinds, one pool per object size. Allocators compare equal
+// when they share their pools, so containers built from copies of one
+// allocator can hand nodes to each other. Containers whose allocators were
+// default constructed separately cannot: check operator== first.
+// Arrays (n > 1) go to operator new. Not thread safe.
+template<typename T>
+class pool_allocator
+{
+	template<typename U> friend class pool_allocator;
+
+public:
+	typedef T			value_type;
+	typedef T*			pointer;
+	typedef const T*	const_pointer;
+	typedef T&			reference;
+	typedef const T&	const_reference;
+	typedef std::size_t	size_type;
+	typedef ptrdiff_t	difference_type;
+
+	template<typename U>
+	struct rebind {
+		typedef pool_allocator<U> other;
+	};
+
+	pool_allocator() :
+		_pools(new internal::pool_set),
+		_pool(NULL)
+	{
+	}
+	pool_allocator(const pool_allocator& other) :
+		_pools(other._pools),
+		_pool(other._pool)
+	{
+		++_pools->refs;
+	}
+	template<typename U>
+	pool_allocator(const pool_allocator<U>& other) :
+		_pools(other._pools),
+		_pool(NULL)
+	{
+		++_pools->refs;
+	}
+	~pool_allocator()
+	{
+		unref();
+	}
+
+	pool_allocator& operator=(const pool_allocator& other)
+	{
+		++other._pools->refs;
+		unref();
+		_pools = other._pools;
+		_pool = other._pool;
+		return *this;
+	}
+
+	pointer allocate(size_type n, const void* hint = NULL)
+	{
+		(void)hint;
+		if (n == 1)
+			return static_cast<pointer>(pool()->allocate());
+		if (n > max_size())
+			throw std::bad_alloc();
+		return static_cast<pointer>(::operator new(n * sizeof(T)));
+	}
+	void deallocate(pointer p, size_type n)
+	{
+		if (n == 1)
+			pool()->deallocate(p);
+		else
+			::operator delete(p);
+	}
+
+	void construct(pointer p, const T& value) { new(static_cast<void*>(p)) T(value); }
+#ifdef FT_CXX11
+	template<typename U, typename... Args>
+	void construct(U* p, Args&&... args) { new(static_cast<void*>(p)) U(std::forward<Args>(args)...); }
+#endif
+	void destroy(pointer p) { p->~T(); }
+
+	pointer address(reference x) const { return &x; }
+	const_pointer address(const_reference x) const { return &x; }
+	size_type max_size() const { return size_type(-1) / sizeof(T); }
+
+	// The pool for objects of type T, made on first use
+	node_pool* pool() const
+	{
+		if (!_pool)
+			_pool = _pools->get(sizeof(T));
+		return _pool;
+	}
+	const internal::pool_set* pools() const { return _pools; }
+
+private:
+	void unref()
+	{
+		if (--_pools->refs == 0)
+			delete _pools;
+	}
+
+	internal::pool_set*	_pools;
+	mutable node_pool*	_pool;
+};
+
+template<typename T, typename U>
+bool operator==(const pool_allocator<T>& a, const pool_allocator<U>& b)
+{
+	return a.pools() == b.pools();
+}
+
+template<typename T, typename U>
+bool operator!=(const pool_allocator<T>& a, const pool_allocator<U>& b)
+{
+	return !(a == b);
+}
+
+} //ft
+
+#endif // POOL_ALLOCATOR_HPP
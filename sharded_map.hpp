@@ -0,0 +1,325 @@
+#ifndef SHARDED_MAP_HPP
+#define SHARDED_MAP_HPP
+
+#include <pthread.h>
+#include <cstddef>
+#include <memory>
+#include <new>
+#include "utils.hpp"
+#include "compare.hpp"
+#include "hash.hpp"
+#include "map.hpp"
+#include "vector.hpp"
+
+namespace ft
+{
+
+namespace internal
+{
+
+// Reader/writer lock, pthread based so it is usable before C++11
+class rw_lock
+{
+public:
+	rw_lock() { pthread_rwlock_init(&_lock, NULL); }
+	~rw_lock() { pthread_rwlock_destroy(&_lock); }
+
+	void lock() { pthread_rwlock_wrlock(&_lock); }
+	void unlock() { pthread_rwlock_unlock(&_lock); }
+	void lock_shared() { pthread_rwlock_rdlock(&_lock); }
+	void unlock_shared() { pthread_rwlock_unlock(&_lock); }
+
+private:
+	rw_lock(const rw_lock&);
+	rw_lock& operator=(const rw_lock&);
+
+	pthread_rwlock_t _lock;
+};
+
+class unique_guard
+{
+public:
+	explicit unique_guard(rw_lock& lock) : _lock(lock) { _lock.lock(); }
+	~unique_guard() { _lock.unlock(); }
+
+private:
+	unique_guard(const unique_guard&);
+	unique_guard& operator=(const unique_guard&);
+
+	rw_lock& _lock;
+};
+
+class shared_guard
+{
+public:
+	explicit shared_guard(rw_lock& lock) : _lock(lock) { _lock.lock_shared(); }
+	~shared_guard() { _lock.unlock_shared(); }
+
+private:
+	shared_guard(const shared_guard&);
+	shared_guard& operator=(const shared_guard&);
+
+	rw_lock& _lock;
+};
+
+} //internal
+
+// Thread safe map, keys are hashed across independent ft::map shards that
+// each have their own reader/writer lock. Lookups and updates lock a
+// single shard, ordered scans lock every shard shared and merge them.
+// Elements are handed out by copy, as no reference outlives its lock.
+template <typename Key, typename T, typename Compare = ft::less<Key>, typename Hash = ft::hash<Key>,
+		  typename Allocator = std::allocator<ft::pair<const Key, T> > >
+class sharded_map
+{
+public:
+	typedef Key										key_type;
+	typedef T										mapped_type;
+	typedef ft::pair<const Key, T>					value_type;
+	typedef std::size_t								size_type;
+	typedef Compare									key_compare;
+	typedef Hash									hasher;
+	typedef Allocator								allocator_type;
+	typedef ft::map<Key, T, Compare, Allocator>		shard_type;
+
+	explicit sharded_map(size_type shards = 16, const key_compare& comp = key_compare(),
+						 const hasher& hash = hasher(), const allocator_type& alloc = allocator_type()) :
+		_count(shards ? shards : 1),
+		_shards(static_cast<shard*>(::operator new(sizeof(shard) * _count))),
+		_comp(comp),
+		_hash(hash)
+	{
+		size_type i = 0;
+		try
+		{
+			for (; i < _count; i++)
+				new (_shards + i) shard(comp, alloc);
+		}
+		catch (...)
+		{
+			destroy(i);
+			throw;
+		}
+	}
+	~sharded_map() { destroy(_count); }
+
+	size_type shard_count() const { return _count; }
+	key_compare key_comp() const { return _comp; }
+	hasher hash_function() const { return _hash; }
+
+	// Sums the shards one after the other, locking one at a time. Under
+	// concurrent writers the result is no single snapshot of the map, as
+	// shards already counted may change while the others are read.
+	size_type size() const
+	{
+		size_type res = 0;
+		for (size_type i = 0; i < _count; i++)
+		{
+			internal::shared_guard lock(_shards[i].lock);
+			res += _shards[i].map.size();
+		}
+		return res;
+	}
+	bool empty() const { return size() == 0; }
+
+	void clear()
+	{
+		for (size_type i = 0; i < _count; i++)
+		{
+			internal::unique_guard lock(_shards[i].lock);
+			_shards[i].map.clear();
+		}
+	}
+
+	bool insert(const value_type& value)
+	{
+		shard& s = shardOf(value.first);
+		internal::unique_guard lock(s.lock);
+		return s.map.insert(value).second;
+	}
+
+	// Returns true when the key was inserted rather than assigned
+	bool insert_or_assign(const key_type& key, const mapped_type& value)
+	{
+		shard& s = shardOf(key);
+		internal::unique_guard lock(s.lock);
+		typename shard_type::iterator it = s.map.lower_bound(key);
+		if (it != s.map.end() && !_comp(key, (*it).first))
+		{
+			(*it).second = value;
+			return false;
+		}
+		s.map.insert(it, value_type(key, value));
+		return true;
+	}
+
+	size_type erase(const key_type& key)
+	{
+		shard& s = shardOf(key);
+		internal::unique_guard lock(s.lock);
+		return s.map.erase(key);
+	}
+
+	size_type count(const key_type& key) const
+	{
+		shard& s = shardOf(key);
+		internal::shared_guard lock(s.lock);
+		return s.map.count(key);
+	}
+
+	// Copies the value of key to out, returns false when it is missing
+	bool find(const key_type& key, mapped_type& out) const
+	{
+		shard& s = shardOf(key);
+		internal::shared_guard lock(s.lock);
+		const shard_type& m = s.map;
+		const_iterator it = m.find(key);
+		if (it == m.end())
+			return false;
+		out = (*it).second;
+		return true;
+	}
+
+	// Calls fn(mapped_type&) on the value of key under the shard lock,
+	// returns false when the key is missing
+	template <typename Fn>
+	bool update(const key_type& key, Fn fn)
+	{
+		shard& s = shardOf(key);
+		internal::unique_guard lock(s.lock);
+		typename shard_type::iterator it = s.map.find(key);
+		if (it == s.map.end())
+			return false;
+		fn((*it).second);
+		return true;
+	}
+
+	// Copies the first element not less than key to out, returns false
+	// when there is none
+	bool lower_bound(const key_type& key, ft::pair<Key, T>& out) const
+	{
+		AllShared lock(*this);
+		const_iterator best;
+		bool found = false;
+		for (size_type i = 0; i < _count; i++)
+		{
+			const shard_type& m = shardAt(i);
+			const_iterator it = m.lower_bound(key);
+			if (it != m.end() && (!found || _comp((*it).first, (*best).first)))
+			{
+				best = it;
+				found = true;
+			}
+		}
+		if (found)
+			out = ft::pair<Key, T>((*best).first, (*best).second);
+		return found;
+	}
+
+	// Calls fn(const value_type&) on every element in key order, on a
+	// consistent view, as writers wait for the whole scan
+	template <typename Fn>
+	void for_each(Fn fn) const
+	{
+		AllShared lock(*this);
+		ft::vector<const_iterator> heads;
+		heads.reserve(_count);
+		for (size_type i = 0; i < _count; i++)
+			heads.push_back(shardAt(i).begin());
+		mergeScan(heads, NULL, fn);
+	}
+
+	// Same as for_each on the elements in [first, last)
+	template <typename Fn>
+	void for_each(const key_type& first, const key_type& last, Fn fn) const
+	{
+		AllShared lock(*this);
+		ft::vector<const_iterator> heads;
+		heads.reserve(_count);
+		for (size_type i = 0; i < _count; i++)
+			heads.push_back(shardAt(i).lower_bound(first));
+		mergeScan(heads, &last, fn);
+	}
+
+private:
+	typedef typename shard_type::const_iterator		const_iterator;
+
+	enum { cache_line = 64 };
+
+	// Padded so the locks of neighbouring shards are on distinct lines
+	struct shard
+	{
+		shard(const key_compare& comp, const allocator_type& alloc) : map(comp, alloc) {}
+
+		internal::rw_lock	lock;
+		shard_type			map;
+		char				padding[cache_line];
+	};
+
+	// Locks every shard shared, always in index order so that concurrent
+	// scans cannot deadlock
+	class AllShared
+	{
+	public:
+		explicit AllShared(const sharded_map& m) : _m(m)
+		{
+			for (size_type i = 0; i < _m._count; i++)
+				_m._shards[i].lock.lock_shared();
+		}
+		~AllShared()
+		{
+			for (size_type i = _m._count; i-- > 0;)
+				_m._shards[i].lock.unlock_shared();
+		}
+
+	private:
+		AllShared(const AllShared&);
+		AllShared& operator=(const AllShared&);
+
+		const sharded_map& _m;
+	};
+
+	sharded_map(const sharded_map&);
+	sharded_map& operator=(const sharded_map&);
+
+	shard& shardOf(const key_type& key) const
+	{
+		return _shards[internal::mix_hash(_hash(key)) % _count];
+	}
+
+	const shard_type& shardAt(size_type i) const { return _shards[i].map; }
+
+	// Shards are few, so the smallest head is found by a linear pass
+	template <typename Fn>
+	void mergeScan(ft::vector<const_iterator>& heads, const key_type* last, Fn& fn) const
+	{
+		for (;;)
+		{
+			size_type best = _count;
+			for (size_type i = 0; i < _count; i++)
+				if (heads[i] != shardAt(i).end()
+					&& (best == _count || _comp((*heads[i]).first, (*heads[best]).first)))
+					best = i;
+			if (best == _count || (last && !_comp((*heads[best]).first, *last)))
+				return;
+			fn(*heads[best]);
+			++heads[best];
+		}
+	}
+
+	void destroy(size_type n)
+	{
+		while (n-- > 0)
+			_shards[n].~shard();
+		::operator delete(_shards);
+	}
+
+	size_type	_count;
+	shard*		_shards;
+	key_compare	_comp;
+	hasher		_hash;
+};
+
+} //ft
+
+#endif // SHARDED_MAP_HPP
@@ -0,0 +1,196 @@
+#ifndef SMALL_VECTOR_HPP
+#define SMALL_VECTOR_HPP
+
+#include <memory>
+#include <stdexcept>
+#include "vector.hpp"
+
+namespace ft
+{
+
+// Same interface as ft::vector, but the first N elements live inside the
+// object itself. The allocator is only used once the size grows past N.
+// N may not be 0, use ft::vector then.
+template<typename T, std::size_t N, typename Allocator = std::allocator<T> >
+class small_vector : public internal::vector_base<T, Allocator, ft::growth_double,
+	small_vector<T, N, Allocator> > {
+	typedef internal::vector_base<T, Allocator, ft::growth_double, small_vector>	base;
+	friend class internal::vector_base<T, Allocator, ft::growth_double, small_vector>;
+
+	typedef char	inline_capacity_must_not_be_zero[N ? 1 : -1];
+
+public:
+	typedef typename base::value_type				value_type;
+	typedef typename base::allocator_type			allocator_type;
+	typedef typename base::reference				reference;
+	typedef typename base::const_reference			const_reference;
+	typedef typename base::pointer					pointer;
+	typedef typename base::const_pointer			const_pointer;
+	typedef typename base::iterator					iterator;
+	typedef typename base::const_iterator			const_iterator;
+	typedef typename base::reverse_iterator			reverse_iterator;
+	typedef typename base::const_reverse_iterator	const_reverse_iterator;
+	typedef typename base::size_type				size_type;
+	typedef typename base::difference_type			difference_type;
+
+	small_vector() :
+		base(storage(this), N, Allocator())
+	{
+	}
+	explicit small_vector(const Allocator& alloc) :
+		base(storage(this), N, alloc)
+	{
+	}
+	explicit small_vector(size_type n) :
+		base(storage(this), N, Allocator())
+	{
+		this->init(n, value_type());
+	}
+	small_vector(size_type n, const T& value, const Allocator& alloc = Allocator()) :
+		base(storage(this), N, alloc)
+	{
+		this->init(n, value);
+	}
+
+	template<typename InputIt>
+	small_vector(InputIt first, InputIt last, const Allocator& alloc = Allocator(),
+	typename ft::enable_if<!ft::is_integral<InputIt>::value, InputIt>::type* = NULL) :
+		base(storage(this), N, alloc)
+	{
+		this->range_init(first, last,
+			internal::to_ft_category(typename ft::iterator_traits<InputIt>::iterator_category()));
+	}
+
+	small_vector(const small_vector& other) :
+		base(storage(this), N, other._alloc)
+	{
+		this->copy_init(other);
+	}
+
+#ifdef FT_CXX11
+	small_vector(small_vector&& other) :
+		base(storage(this), N, other._alloc)
+	{
+		steal(other);
+	}
+#endif
+
+	~small_vector()
+	{
+		this->clear();
+		this->release();
+	}
+
+	small_vector& operator=(const small_vector& other)
+	{
+		if (&other != this)
+			this->copy_assign(other);
+		return *this;
+	}
+#ifdef FT_CXX11
+	small_vector& operator=(small_vector&& other)
+	{
+		if (&other == this)
+			return *this;
+		this->clear();
+		this->release();
+		reset_storage();
+		this->_alloc = other._alloc;
+		steal(other);
+		return *this;
+	}
+#endif
+
+	bool is_inline() const { return this->_data == inline_data(); }
+
+	// Heap buffers are exchanged, inline elements are relocated
+	void swap(small_vector& other)
+	{
+		if (&other == this)
+			return;
+		small_vector tmp(this->_alloc);
+		tmp.steal(*this);
+		steal(other);
+		other.steal(tmp);
+		ft::swap(this->_alloc, other._alloc);
+	}
+
+private:
+	bool on_heap() const { return !is_inline(); }
+	void reset_storage()
+	{
+		this->_data = inline_data();
+		this->_capacity = N;
+	}
+
+	// Takes the elements of other, which is left empty and inline.
+	// We must hold no elements and no heap buffer.
+	void steal(small_vector& other)
+	{
+		if (other.is_inline())
+			this->relocate(this->_data, other._data, other._size);
+		else
+		{
+			this->_data = other._data;
+			this->_capacity = other._capacity;
+			other.reset_storage();
+		}
+		this->_size = other._size;
+		other._size = 0;
+	}
+
+	// The inline buffer of self, for the base which is built first
+	static pointer storage(small_vector* self) { return reinterpret_cast<pointer>(&self->_storage); }
+	pointer inline_data() { return reinterpret_cast<pointer>(_storage.bytes); }
+	const_pointer inline_data() const { return reinterpret_cast<const_pointer>(_storage.bytes); }
+
+	union
+	{
+		char		bytes[N * sizeof(T)];
+		long double	align_ld;
+		long long	align_ll;
+		void*		align_ptr;
+	}				_storage;
+};
+
+template<typename T, std::size_t N, typename A>
+bool operator==(const small_vector<T, N, A>& a, const small_vector<T, N, A>& b)
+{
+	if (a.size() != b.size())
+		return false;
+	return ft::equal(a.begin(), a.end(), b.begin());
+}
+
+template<typename T, std::size_t N, typename A>
+bool operator!=(const small_vector<T, N, A>& a, const small_vector<T, N, A>& b)
+{
+	return !(a == b);
+}
+
+template<typename T, std::size_t N, typename A>
+bool operator<(const small_vector<T, N, A>& a, const small_vector<T, N, A>& b)
+{
+	return ft::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end());
+}
+
+template<typename T, std::size_t N, typename A>
+bool operator>(const small_vector<T, N, A>& a, const small_vector<T, N, A>& b)
+{
+	return (b < a);
+}
+
+template<typename T, std::size_t N, typename A>
+bool operator<=(const small_vector<T, N, A>& a, const small_vector<T, N, A>& b)
+{
+	return !(a > b);
+}
+
+template<typename T, std::size_t N, typename A>
+bool operator>=(const small_vector<T, N, A>& a, const small_vector<T, N, A>& b)
+{
+	return !(a < b);
+}
+
+} //ft
+
+#endif // SMALL_VECTOR_HPP
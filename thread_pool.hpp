@@ -0,0 +1,190 @@
+#ifndef THREAD_POOL_HPP
+#define THREAD_POOL_HPP
+
+#include "utils.hpp"
+
+#ifdef FT_CXX11
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <exception>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+namespace ft
+{
+
+// Worker threads for the parallel operations of the containers. Every
+// worker pops tasks from the back of its own deque, and once it is empty
+// steals from the front of the others. A thread waiting for its tasks
+// runs queued ones meanwhile, so tasks may start tasks of their own.
+class thread_pool
+{
+public:
+	explicit thread_pool(unsigned threads = std::thread::hardware_concurrency()) :
+		_count(threads ? threads : 1),
+		_queues(new queue[_count]),
+		_pending(0),
+		_next(0),
+		_stop(false)
+	{
+		for (unsigned i = 0; i < _count; i++)
+			_threads.emplace_back(&thread_pool::work, this, i);
+	}
+	~thread_pool()
+	{
+		{
+			std::lock_guard<std::mutex> lock(_sleep);
+			_stop = true;
+		}
+		_wake.notify_all();
+		for (std::size_t i = 0; i < _threads.size(); i++)
+			_threads[i].join();
+	}
+
+	thread_pool(const thread_pool&) = delete;
+	thread_pool& operator=(const thread_pool&) = delete;
+
+	unsigned size() const { return _count; }
+
+	// Calls fn(i) for every i in [0, n) and returns once all calls are
+	// done, rethrowing the first exception one of them threw
+	template <typename Fn>
+	void run(std::size_t n, const Fn& fn)
+	{
+		batch b(n);
+
+		for (std::size_t i = 0; i < n; i++)
+			push(_next++ % _count, [&b, &fn, i]()
+			{
+				try
+				{
+					fn(i);
+				}
+				catch (...)
+				{
+					std::lock_guard<std::mutex> lock(b.lock);
+					if (!b.error)
+						b.error = std::current_exception();
+				}
+				std::lock_guard<std::mutex> lock(b.lock);
+				if (--b.remaining == 0)
+					b.done.notify_all();
+			});
+		while (b.remaining > 0)
+		{
+			if (runOne(0))
+				continue;
+			// Wakes up now and then, as tasks queued meanwhile do not notify
+			std::unique_lock<std::mutex> lock(b.lock);
+			b.done.wait_for(lock, std::chrono::milliseconds(1),
+				[&b]() { return b.remaining == 0; });
+		}
+		// The last task may still hold the lock
+		std::lock_guard<std::mutex> lock(b.lock);
+		if (b.error)
+			std::rethrow_exception(b.error);
+	}
+
+private:
+	typedef std::function<void()>	task;
+
+	struct queue
+	{
+		std::mutex			lock;
+		std::deque<task>	tasks;
+	};
+
+	struct batch
+	{
+		explicit batch(std::size_t n) : remaining(n) {}
+
+		std::atomic<std::size_t>	remaining;
+		std::mutex					lock;
+		std::condition_variable		done;
+		std::exception_ptr			error;
+	};
+
+	void push(unsigned index, task t)
+	{
+		{
+			std::lock_guard<std::mutex> lock(_queues[index].lock);
+			_queues[index].tasks.push_back(std::move(t));
+		}
+		{
+			std::lock_guard<std::mutex> lock(_sleep);
+			_pending++;
+		}
+		_wake.notify_one();
+	}
+
+	// Takes a task from the back of queue index, or else from the front of
+	// another one
+	bool take(unsigned index, task& t)
+	{
+		for (unsigned i = 0; i < _count; i++)
+		{
+			queue& q = _queues[(index + i) % _count];
+			std::lock_guard<std::mutex> lock(q.lock);
+			if (q.tasks.empty())
+				continue;
+			if (i == 0)
+			{
+				t = std::move(q.tasks.back());
+				q.tasks.pop_back();
+			}
+			else
+			{
+				t = std::move(q.tasks.front());
+				q.tasks.pop_front();
+			}
+			std::lock_guard<std::mutex> sleep(_sleep);
+			_pending--;
+			return true;
+		}
+		return false;
+	}
+
+	bool runOne(unsigned index)
+	{
+		task t;
+		if (!take(index, t))
+			return false;
+		t();
+		return true;
+	}
+
+	void work(unsigned index)
+	{
+		for (;;)
+		{
+			if (runOne(index))
+				continue;
+			std::unique_lock<std::mutex> lock(_sleep);
+			_wake.wait(lock, [this]() { return _stop || _pending > 0; });
+			if (_stop && _pending == 0)
+				return;
+		}
+	}
+
+	unsigned					_count;
+	std::unique_ptr<queue[]>	_queues;
+	std::vector<std::thread>	_threads;
+	std::size_t					_pending;
+	std::atomic<unsigned>		_next;
+	bool						_stop;
+	std::mutex					_sleep;
+	std::condition_variable		_wake;
+};
+
+} //ft
+
+#endif
+
+#endif // THREAD_POOL_HPP
@@ -0,0 +1,806 @@
+#ifndef UNORDERED_MAP_HPP
+#define UNORDERED_MAP_HPP
+
+#include <cstring>
+#include <memory>
+#include <stdexcept>
+#ifdef __SSE2__
+# include <emmintrin.h>
+#endif
+#include "iterator.hpp"
+#include "utils.hpp"
+#include "compare.hpp"
+#include "hash.hpp"
+#include "vector.hpp"
+
+namespace ft
+{
+
+namespace internal
+{
+
+enum
+{
+	hash_group_width = 16
+};
+
+// Control bytes, one per slot. A full slot holds the low 7 bits of its
+// hash, free ones have the high bit set.
+static const unsigned char ctrl_empty = 0x80;
+static const unsigned char ctrl_sentinel = 0xff;
+
+// hash_group_width control bytes loaded at once. match returns a bitmask
+// of the bytes equal to h2, match_free of the empty or sentinel ones.
+class hash_group
+{
+public:
+#ifdef __SSE2__
+	explicit hash_group(const unsigned char* ctrl) :
+		_ctrl(_mm_loadu_si128(reinterpret_cast<const __m128i*>(ctrl)))
+	{}
+
+	unsigned int match(unsigned char h2) const
+	{
+		return _mm_movemask_epi8(_mm_cmpeq_epi8(_ctrl, _mm_set1_epi8(static_cast<char>(h2))));
+	}
+	unsigned int match_free() const
+	{
+		return _mm_movemask_epi8(_ctrl);
+	}
+
+private:
+	__m128i	_ctrl;
+#else
+	explicit hash_group(const unsigned char* ctrl) : _ctrl(ctrl) {}
+
+	unsigned int match(unsigned char h2) const
+	{
+		unsigned int mask = 0;
+		for (int i = 0; i < hash_group_width; i++)
+			mask |= (unsigned int)(_ctrl[i] == h2) << i;
+		return mask;
+	}
+	unsigned int match_free() const
+	{
+		unsigned int mask = 0;
+		for (int i = 0; i < hash_group_width; i++)
+			mask |= (unsigned int)(_ctrl[i] >> 7) << i;
+		return mask;
+	}
+
+private:
+	const unsigned char*	_ctrl;
+#endif
+};
+
+inline unsigned int lowest_bit(unsigned int mask)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	return __builtin_ctz(mask);
+#else
+	unsigned int i = 0;
+	while (!(mask & 1))
+	{
+		mask >>= 1;
+		i++;
+	}
+	return i;
+#endif
+}
+
+// Control bytes of a table with no slots, so lookups need no special case
+inline unsigned char* empty_ctrl()
+{
+	static unsigned char ctrl[hash_group_width] = {
+		ctrl_sentinel, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty,
+		ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty, ctrl_empty
+	};
+	return ctrl;
+}
+
+} //internal
+
+// Open addressing hash map storing its elements inline in one array,
+// Swiss table style: the control bytes of 16 slots are probed at once.
+// Probing is linear and never wraps around: the table has an overflow
+// tail after its capacity, and a sentinel after that. Erasing shifts the
+// rest of the cluster back instead of leaving tombstones, so lookups
+// never walk over dead slots and erasing while iterating visits every
+// element once.
+// Inserting may move every element, erasing may move the following
+// ones: both invalidate iterators and references.
+template <typename Key, typename T, typename Hash = ft::hash<Key>, typename KeyEqual = ft::equal_to<Key>,
+	typename Allocator = std::allocator<ft::pair<const Key, T> > >
+class unordered_map
+{
+private:
+	typedef internal::alloc_traits<Allocator>	alloc_traits;
+
+public:
+	typedef Allocator									allocator_type;
+	typedef typename alloc_traits::value_type			value_type;
+	typedef Key											key_type;
+	typedef T											data_type;
+	typedef T											mapped_type;
+	typedef Hash										hasher;
+	typedef KeyEqual									key_equal;
+	typedef typename alloc_traits::pointer				pointer;
+	typedef typename alloc_traits::const_pointer		const_pointer;
+	typedef typename alloc_traits::reference			reference;
+	typedef typename alloc_traits::const_reference		const_reference;
+	typedef typename alloc_traits::size_type			size_type;
+	typedef typename alloc_traits::difference_type		difference_type;
+	typedef typename alloc_traits::template rebind<unsigned char>::other	ctrl_allocator;
+
+	template<typename DataType>
+	class HashIterator
+	{
+	public:
+		typedef DataType								value_type;
+		typedef DataType*								pointer;
+		typedef DataType&								reference;
+		typedef ft::forward_iterator_tag				iterator_category;
+		typedef typename alloc_traits::difference_type	difference_type;
+
+		HashIterator() :
+			_ctrl(NULL),
+			_slot(NULL)
+		{}
+		HashIterator(const unsigned char* ctrl, DataType* slot) :
+			_ctrl(ctrl),
+			_slot(slot)
+		{}
+		template<typename U>
+		HashIterator(const HashIterator<U>& other) :
+			_ctrl(other.ctrl()),
+			_slot(other.slot())
+		{}
+
+		reference operator*() const { return *_slot; }
+		pointer operator->() const { return _slot; }
+
+		// Stops on the next full slot or on the sentinel
+		HashIterator& operator++() {
+			do
+			{
+				++_ctrl;
+				++_slot;
+			} while (*_ctrl == internal::ctrl_empty);
+			return *this;
+		}
+		HashIterator operator++(int)
+		{
+			HashIterator tmp = *this;
+			++*this;
+			return tmp;
+		}
+
+		bool operator==(const HashIterator& other) const { return _ctrl == other._ctrl; }
+		bool operator!=(const HashIterator& other) const { return _ctrl != other._ctrl; }
+
+		const unsigned char* ctrl() const { return _ctrl; }
+		DataType* slot() const { return _slot; }
+
+	private:
+		const unsigned char*	_ctrl;
+		DataType*				_slot;
+	};
+
+	typedef HashIterator<value_type>			iterator;
+	typedef HashIterator<const value_type>		const_iterator;
+
+	//constructors
+	unordered_map() :
+		_ctrl(internal::empty_ctrl()),
+		_slots(NULL),
+		_capacity(0),
+		_slot_count(0),
+		_size(0),
+		_hash(Hash()),
+		_eq(KeyEqual()),
+		_alloc(Allocator()),
+		_ctrl_alloc(_alloc)
+	{
+	}
+	explicit unordered_map(size_type bucket_count, const hasher& hash = hasher(),
+		const key_equal& eq = key_equal(), const allocator_type& alloc = allocator_type()) :
+		_ctrl(internal::empty_ctrl()),
+		_slots(NULL),
+		_capacity(0),
+		_slot_count(0),
+		_size(0),
+		_hash(hash),
+		_eq(eq),
+		_alloc(alloc),
+		_ctrl_alloc(_alloc)
+	{
+		rehash(bucket_count);
+	}
+	template <typename InputIt>
+	unordered_map(InputIt first, InputIt last, size_type bucket_count = 0,
+		const hasher& hash = hasher(), const key_equal& eq = key_equal(),
+		const allocator_type& alloc = allocator_type(),
+	typename ft::enable_if<!ft::is_integral<InputIt>::value, InputIt>::type* = NULL) :
+		_ctrl(internal::empty_ctrl()),
+		_slots(NULL),
+		_capacity(0),
+		_slot_count(0),
+		_size(0),
+		_hash(hash),
+		_eq(eq),
+		_alloc(alloc),
+		_ctrl_alloc(_alloc)
+	{
+		if (bucket_count)
+			rehash(bucket_count);
+		insert(first, last);
+	}
+	unordered_map(const unordered_map& other) :
+		_ctrl(internal::empty_ctrl()),
+		_slots(NULL),
+		_capacity(0),
+		_slot_count(0),
+		_size(0),
+		_hash(other._hash),
+		_eq(other._eq),
+		_alloc(other._alloc),
+		_ctrl_alloc(other._ctrl_alloc)
+	{
+		copy(other);
+	}
+	unordered_map& operator=(const unordered_map& other)
+	{
+		if (this == &other)
+			return *this;
+		release();
+
+		_hash = other._hash;
+		_eq = other._eq;
+		_alloc = other._alloc;
+		_ctrl_alloc = other._ctrl_alloc;
+		copy(other);
+		return *this;
+	}
+
+#ifdef FT_CXX11
+	unordered_map(unordered_map&& other) :
+		_ctrl(other._ctrl),
+		_slots(other._slots),
+		_capacity(other._capacity),
+		_slot_count(other._slot_count),
+		_size(other._size),
+		_hash(std::move(other._hash)),
+		_eq(std::move(other._eq)),
+		_alloc(other._alloc),
+		_ctrl_alloc(other._ctrl_alloc)
+	{
+		other.reset();
+	}
+	unordered_map& operator=(unordered_map&& other)
+	{
+		if (this == &other)
+			return *this;
+		release();
+		swap(other);
+		return *this;
+	}
+#endif
+
+	~unordered_map()
+	{
+		release();
+	}
+
+	allocator_type get_allocator() const { return _alloc; }
+
+	//element access
+	T& at(const key_type& key)
+	{
+		iterator it = find(key);
+		if (it == end())
+			throw std::out_of_range("unordered_map::at");
+		return (*it).second;
+	}
+	const T& at(const key_type& key) const
+	{
+		const_iterator it = find(key);
+		if (it == end())
+			throw std::out_of_range("unordered_map::at");
+		return (*it).second;
+	}
+	T& operator[](const key_type& key)
+	{
+#ifdef FT_CXX11
+		return (*try_emplace(key).first).second;
+#else
+		const std::size_t h = hashOf(key);
+		bool found;
+		size_type i = probe(key, h, found);
+		if (found)
+			return _slots[i].second;
+		// key may refer into the slots, which growing frees
+		if (crowded(i))
+		{
+			const value_type value(key, mapped_type());
+			i = grow(h);
+			fill(i, h, value);
+		}
+		else
+			fill(i, h, value_type(key, mapped_type()));
+		return _slots[i].second;
+#endif
+	}
+#ifdef FT_CXX11
+	T& operator[](key_type&& key)
+	{
+		return (*try_emplace(std::move(key)).first).second;
+	}
+#endif
+
+	//iterators
+	iterator begin() { return skip(0); }
+	const_iterator begin() const { return const_cast<unordered_map*>(this)->skip(0); }
+	iterator end() { return iterator(_ctrl + _slot_count, _slots + _slot_count); }
+	const_iterator end() const { return const_iterator(_ctrl + _slot_count, _slots + _slot_count); }
+
+	//capacity
+	bool empty() const { return _size == 0; }
+	size_type size() const { return _size; }
+	size_type max_size() const { return alloc_traits::max_size(_alloc) / 2; }
+
+	//modifiers
+	// Keeps the slots allocated
+	void clear()
+	{
+		if (_capacity == 0)
+			return;
+		for (size_type i = 0; i < _slot_count; i++)
+			if (isFull(_ctrl[i]))
+				alloc_traits::destroy(_alloc, _slots + i);
+		std::memset(_ctrl, internal::ctrl_empty, _slot_count);
+		_size = 0;
+	}
+
+	ft::pair<iterator,bool> insert(const value_type& value)
+	{
+		std::size_t h;
+		bool found;
+		const size_type i = slotFor(value.first, h, found);
+		if (!found)
+			fill(i, h, value);
+		return ft::make_pair(iteratorAt(i), !found);
+	}
+	// Hashing gives no use for the hint
+	iterator insert(iterator hint, const value_type& value)
+	{
+		(void)hint;
+		return insert(value).first;
+	}
+	template <typename InputIt>
+	void insert(InputIt first, InputIt last,
+	typename ft::enable_if<!ft::is_integral<InputIt>::value, InputIt>::type* = NULL)
+	{
+		for (; first != last; ++first)
+			insert(*first);
+	}
+#ifdef FT_CXX11
+	ft::pair<iterator,bool> insert(value_type&& value)
+	{
+		std::size_t h;
+		bool found;
+		const size_type i = slotFor(value.first, h, found);
+		if (!found)
+			fill(i, h, std::move(value));
+		return ft::make_pair(iteratorAt(i), !found);
+	}
+
+	template<typename... Args>
+	ft::pair<iterator,bool> emplace(Args&&... args)
+	{
+		return insert(value_type(std::forward<Args>(args)...));
+	}
+
+	template<typename... Args>
+	ft::pair<iterator,bool> try_emplace(const key_type& key, Args&&... args)
+	{
+		const std::size_t h = hashOf(key);
+		bool found;
+		size_type i = probe(key, h, found);
+		if (!found)
+			i = emplaceAt(i, h, key, std::forward<Args>(args)...);
+		return ft::make_pair(iteratorAt(i), !found);
+	}
+	template<typename... Args>
+	ft::pair<iterator,bool> try_emplace(key_type&& key, Args&&... args)
+	{
+		const std::size_t h = hashOf(key);
+		bool found;
+		size_type i = probe(key, h, found);
+		if (!found)
+			i = emplaceAt(i, h, std::move(key), std::forward<Args>(args)...);
+		return ft::make_pair(iteratorAt(i), !found);
+	}
+#endif
+
+	// Returns the element that followed position, which may have been
+	// shifted into its slot
+	iterator erase(iterator position)
+	{
+		const size_type i = indexOf(position);
+		eraseSlot(i);
+		return skip(i);
+	}
+	// Erased back to front: shifting only moves elements from after the
+	// erased slot, so the ones left to erase stay in place
+	iterator erase(iterator first, iterator last)
+	{
+		const size_type lo = indexOf(first);
+		size_type hi = indexOf(last);
+		while (hi > lo)
+			if (isFull(_ctrl[--hi]))
+				eraseSlot(hi);
+		return skip(lo);
+	}
+	size_type erase(const key_type& key)
+	{
+		bool found;
+		const size_type i = probe(key, hashOf(key), found);
+		if (!found)
+			return 0;
+		eraseSlot(i);
+		return 1;
+	}
+
+	void swap(unordered_map& other)
+	{
+		ft::swap(_ctrl, other._ctrl);
+		ft::swap(_slots, other._slots);
+		ft::swap(_capacity, other._capacity);
+		ft::swap(_slot_count, other._slot_count);
+		ft::swap(_size, other._size);
+		ft::swap(_hash, other._hash);
+		ft::swap(_eq, other._eq);
+		ft::swap(_alloc, other._alloc);
+		ft::swap(_ctrl_alloc, other._ctrl_alloc);
+	}
+
+	//lookup
+	size_type count(const key_type& key) const
+	{
+		bool found;
+		probe(key, hashOf(key), found);
+		return found;
+	}
+	iterator find(const key_type& key)
+	{
+		bool found;
+		const size_type i = probe(key, hashOf(key), found);
+		return found ? iteratorAt(i) : end();
+	}
+	const_iterator find(const key_type& key) const
+	{
+		return const_cast<unordered_map*>(this)->find(key);
+	}
+	ft::pair<iterator,iterator> equal_range(const key_type& key)
+	{
+		iterator it = find(key);
+		if (it == end())
+			return ft::make_pair(it, it);
+		iterator next = it;
+		return ft::make_pair(it, ++next);
+	}
+	ft::pair<const_iterator,const_iterator> equal_range(const key_type& key) const
+	{
+		return const_cast<unordered_map*>(this)->equal_range(key);
+	}
+
+	//hash policy
+	// Buckets are the slots an element can hash to, the overflow tail
+	// after them is not counted
+	size_type bucket_count() const { return _capacity; }
+	float load_factor() const { return _capacity ? float(_size) / _capacity : 0.0f; }
+	float max_load_factor() const { return 0.875f; }
+	void rehash(size_type count)
+	{
+		size_type capacity = internal::hash_group_width;
+		while (capacity < count)
+			capacity *= 2;
+		capacity = ft::max(capacity, capacityFor(_size));
+		if (capacity != _capacity)
+			resize(capacity);
+	}
+	void reserve(size_type count)
+	{
+		const size_type capacity = capacityFor(count);
+		if (capacity > _capacity)
+			resize(capacity);
+	}
+
+	//observers
+	hasher hash_function() const { return _hash; }
+	key_equal key_eq() const { return _eq; }
+
+private:
+	static bool isFull(unsigned char ctrl) { return ctrl < internal::ctrl_empty; }
+	static unsigned char h2(std::size_t h) { return h & 0x7f; }
+
+	// Smallest capacity holding count elements below the load limit
+	static size_type capacityFor(size_type count)
+	{
+		size_type capacity = internal::hash_group_width;
+		while (capacity - capacity / 8 < count)
+			capacity *= 2;
+		return capacity;
+	}
+	static size_type tailFor(size_type capacity)
+	{
+		return ft::max(size_type(internal::hash_group_width), capacity / 16);
+	}
+
+	std::size_t hashOf(const key_type& key) const { return internal::mix_hash(_hash(key)); }
+	size_type home(std::size_t h) const { return (h >> 7) & (_capacity - 1); }
+
+	// The slot holding key if found, else the first free slot from its
+	// home, which is past the last slot when the tail overflowed
+	size_type probe(const key_type& key, std::size_t h, bool& found) const
+	{
+		size_type pos = _capacity ? home(h) : 0;
+		for (;;)
+		{
+			internal::hash_group group(_ctrl + pos);
+			for (unsigned int m = group.match(h2(h)); m; m &= m - 1)
+			{
+				const size_type i = pos + internal::lowest_bit(m);
+				if (_eq(_slots[i].first, key))
+				{
+					found = true;
+					return i;
+				}
+			}
+			const unsigned int free = group.match_free();
+			if (free)
+			{
+				found = false;
+				return pos + internal::lowest_bit(free);
+			}
+			pos += internal::hash_group_width;
+		}
+	}
+	static size_type firstFree(const unsigned char* ctrl, size_type pos)
+	{
+		for (;;)
+		{
+			const unsigned int free = internal::hash_group(ctrl + pos).match_free();
+			if (free)
+				return pos + internal::lowest_bit(free);
+			pos += internal::hash_group_width;
+		}
+	}
+
+	// Finds key, or a free slot for it, growing the table when full
+	size_type slotFor(const key_type& key, std::size_t& h, bool& found)
+	{
+		h = hashOf(key);
+		const size_type i = probe(key, h, found);
+		if (found || !crowded(i))
+			return i;
+		return grow(h);
+	}
+
+	// Whether the free slot i may not be filled before the table grows
+	bool crowded(size_type i) const
+	{
+		return _size >= _capacity - _capacity / 8 || i >= _slot_count;
+	}
+	// Grows the table, returning the free slot for hash h
+	size_type grow(std::size_t h)
+	{
+		resize(capacityFor(_size + 1));
+		size_type i = firstFree(_ctrl, home(h));
+		while (i >= _slot_count)
+		{
+			resize(_capacity * 2);
+			i = firstFree(_ctrl, home(h));
+		}
+		return i;
+	}
+
+	void fill(size_type i, std::size_t h, const value_type& value)
+	{
+		alloc_traits::construct(_alloc, _slots + i, value);
+		_ctrl[i] = h2(h);
+		++_size;
+	}
+#ifdef FT_CXX11
+	template<typename... Args>
+	void fill(size_type i, std::size_t h, Args&&... args)
+	{
+		alloc_traits::construct(_alloc, _slots + i, std::forward<Args>(args)...);
+		_ctrl[i] = h2(h);
+		++_size;
+	}
+
+	// Fills the free slot i, or the one found after growing. key and args
+	// may refer into the slots, which growing frees, so the element is
+	// built first then.
+	template<typename K, typename... Args>
+	size_type emplaceAt(size_type i, std::size_t h, K&& key, Args&&... args)
+	{
+		if (!crowded(i))
+		{
+			fill(i, h, std::forward<K>(key), mapped_type(std::forward<Args>(args)...));
+			return i;
+		}
+		value_type value(std::forward<K>(key), mapped_type(std::forward<Args>(args)...));
+		i = grow(h);
+		fill(i, h, std::move(value));
+		return i;
+	}
+#endif
+
+	// Backward shift: the rest of the cluster moves into the hole unless
+	// that would put an element before its home
+	void eraseSlot(size_type i)
+	{
+		alloc_traits::destroy(_alloc, _slots + i);
+		--_size;
+		for (size_type j = i + 1; isFull(_ctrl[j]); j++)
+		{
+			if (home(hashOf(_slots[j].first)) <= i)
+			{
+				internal::relocate(_alloc, _slots + i, _slots + j, 1);
+				_ctrl[i] = _ctrl[j];
+				i = j;
+			}
+		}
+		_ctrl[i] = internal::ctrl_empty;
+	}
+
+	iterator iteratorAt(size_type i) { return iterator(_ctrl + i, _slots + i); }
+	iterator skip(size_type i)
+	{
+		while (_ctrl[i] == internal::ctrl_empty)
+			i++;
+		return iteratorAt(i);
+	}
+	size_type indexOf(const_iterator it) const { return it.ctrl() - _ctrl; }
+
+	unsigned char* allocateCtrl(size_type slot_count)
+	{
+		unsigned char* ctrl = _ctrl_alloc.allocate(slot_count + internal::hash_group_width);
+		std::memset(ctrl, internal::ctrl_empty, slot_count + internal::hash_group_width);
+		ctrl[slot_count] = internal::ctrl_sentinel;
+		return ctrl;
+	}
+
+	// Moves every element to a table of the given capacity. Placements are
+	// tried on the control bytes first, with the capacity doubled until
+	// no cluster runs past the tail.
+	void resize(size_type capacity)
+	{
+		typedef typename alloc_traits::template rebind<std::size_t>::other	hash_allocator;
+
+		hash_allocator hash_alloc(_alloc);
+		std::size_t* hashes = _size ? hash_alloc.allocate(_size) : NULL;
+		size_type n = 0;
+		for (size_type i = 0; i < _slot_count; i++)
+			if (isFull(_ctrl[i]))
+				hashes[n++] = hashOf(_slots[i].first);
+
+		unsigned char* ctrl;
+		size_type slot_count;
+		size_type k;
+		for (;;)
+		{
+			slot_count = capacity + tailFor(capacity);
+			ctrl = allocateCtrl(slot_count);
+			for (k = 0; k < n; k++)
+			{
+				const size_type i = firstFree(ctrl, (hashes[k] >> 7) & (capacity - 1));
+				if (i >= slot_count)
+					break;
+				ctrl[i] = h2(hashes[k]);
+			}
+			if (k == n)
+				break;
+			_ctrl_alloc.deallocate(ctrl, slot_count + internal::hash_group_width);
+			capacity *= 2;
+		}
+
+		pointer slots = _alloc.allocate(slot_count);
+		std::memset(ctrl, internal::ctrl_empty, slot_count);
+		k = 0;
+		for (size_type i = 0; i < _slot_count; i++)
+		{
+			if (!isFull(_ctrl[i]))
+				continue;
+			const size_type pos = firstFree(ctrl, (hashes[k] >> 7) & (capacity - 1));
+			internal::relocate(_alloc, slots + pos, _slots + i, 1);
+			ctrl[pos] = _ctrl[i];
+			k++;
+		}
+		if (hashes)
+			hash_alloc.deallocate(hashes, _size);
+		deallocate();
+
+		_ctrl = ctrl;
+		_slots = slots;
+		_capacity = capacity;
+		_slot_count = slot_count;
+	}
+
+	// Same layout as other, so the control bytes are copied as they are
+	void copy(const unordered_map& other)
+	{
+		if (other._size == 0)
+			return;
+		_ctrl = allocateCtrl(other._slot_count);
+		_slots = _alloc.allocate(other._slot_count);
+		_capacity = other._capacity;
+		_slot_count = other._slot_count;
+		std::memcpy(_ctrl, other._ctrl, _slot_count);
+		for (size_type i = 0; i < _slot_count; i++)
+			if (isFull(_ctrl[i]))
+				alloc_traits::construct(_alloc, _slots + i, other._slots[i]);
+		_size = other._size;
+	}
+
+	void deallocate()
+	{
+		if (_capacity == 0)
+			return;
+		_ctrl_alloc.deallocate(_ctrl, _slot_count + internal::hash_group_width);
+		_alloc.deallocate(_slots, _slot_count);
+	}
+	void release()
+	{
+		clear();
+		deallocate();
+		reset();
+	}
+	void reset()
+	{
+		_ctrl = internal::empty_ctrl();
+		_slots = NULL;
+		_capacity = 0;
+		_slot_count = 0;
+		_size = 0;
+	}
+
+	unsigned char*	_ctrl;
+	pointer			_slots;
+	size_type		_capacity;
+	size_type		_slot_count;
+	size_type		_size;
+	hasher			_hash;
+	key_equal		_eq;
+	allocator_type	_alloc;
+	ctrl_allocator	_ctrl_alloc;
+};
+
+template< class Key, class T, class Hash, class KeyEqual, class Alloc >
+bool operator==(const unordered_map<Key, T, Hash, KeyEqual, Alloc>& a,
+	const unordered_map<Key, T, Hash, KeyEqual, Alloc>& b)
+{
+	if (a.size() != b.size())
+		return false;
+	typedef typename unordered_map<Key, T, Hash, KeyEqual, Alloc>::const_iterator const_iterator;
+	for (const_iterator it = a.begin(); it != a.end(); ++it)
+	{
+		const_iterator other = b.find((*it).first);
+		if (other == b.end() || !((*other).second == (*it).second))
+			return false;
+	}
+	return true;
+}
+
+template< class Key, class T, class Hash, class KeyEqual, class Alloc >
+bool operator!=(const unordered_map<Key, T, Hash, KeyEqual, Alloc>& a,
+	const unordered_map<Key, T, Hash, KeyEqual, Alloc>& b)
+{
+	return !(a == b);
+}
+
+} //ft
+
+#endif // UNORDERED_MAP_HPP
@@ -1,6 +1,20 @@
 #ifndef UTILS_HPP
 #define UTILS_HPP
 
+#include <cstddef>
+
+#if __cplusplus >= 201103L || (defined(_MSVC_LANG) && _MSVC_LANG >= 201103L)
+# define FT_CXX11 1
+#endif
+
+#ifdef FT_CXX11
+# include <memory>
+# include <utility>
+# define FT_MOVE(x) std::move(x)
+#else
+# define FT_MOVE(x) (x)
+#endif
+
 namespace ft
 {
 
@@ -36,6 +50,102 @@ struct not_integral {
 	static const bool value = false;
 };
 
+template<bool B>
+struct bool_constant {
+	static const bool value = B;
+};
+typedef bool_constant<true> true_type;
+typedef bool_constant<false> false_type;
+
+// As strictly aligned as any scalar type
+union max_align {
+	long double	ld;
+	long long	ll;
+	double		d;
+	void*		p;
+	void		(*f)();
+};
+
+// Reference counts of data that copies on other threads may share
+inline void ref_acquire(std::size_t& refs)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	__atomic_add_fetch(&refs, 1, __ATOMIC_RELAXED);
+#else
+	++refs;
+#endif
+}
+
+// Returns true once the last reference is gone
+inline bool ref_release(std::size_t& refs)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	return __atomic_sub_fetch(&refs, 1, __ATOMIC_ACQ_REL) == 0;
+#else
+	return --refs == 0;
+#endif
+}
+
+inline std::size_t ref_count(const std::size_t& refs)
+{
+#if defined(__GNUC__) || defined(__clang__)
+	return __atomic_load_n(&refs, __ATOMIC_ACQUIRE);
+#else
+	return refs;
+#endif
+}
+
+// What the containers need from an allocator. From C++11 on it goes
+// through std::allocator_traits, as C++20 allocators no longer have
+// pointer, reference, rebind, construct or destroy.
+template<typename Alloc>
+struct alloc_traits {
+#ifdef FT_CXX11
+	typedef std::allocator_traits<Alloc>		traits;
+	typedef typename traits::value_type			value_type;
+	typedef typename traits::pointer			pointer;
+	typedef typename traits::const_pointer		const_pointer;
+	typedef value_type&							reference;
+	typedef const value_type&					const_reference;
+	typedef typename traits::size_type			size_type;
+	typedef typename traits::difference_type	difference_type;
+
+	template<typename U>
+	struct rebind {
+		typedef typename traits::template rebind_alloc<U>	other;
+	};
+
+	template<typename U, typename... Args>
+	static void construct(Alloc& alloc, U* p, Args&&... args)
+	{
+		traits::construct(alloc, p, std::forward<Args>(args)...);
+	}
+	template<typename U>
+	static void destroy(Alloc& alloc, U* p) { traits::destroy(alloc, p); }
+	static size_type max_size(const Alloc& alloc) { return traits::max_size(alloc); }
+#else
+	typedef typename Alloc::value_type			value_type;
+	typedef typename Alloc::pointer				pointer;
+	typedef typename Alloc::const_pointer		const_pointer;
+	typedef typename Alloc::reference			reference;
+	typedef typename Alloc::const_reference		const_reference;
+	typedef typename Alloc::size_type			size_type;
+	typedef typename Alloc::difference_type		difference_type;
+
+	template<typename U>
+	struct rebind {
+		typedef typename Alloc::template rebind<U>::other	other;
+	};
+
+	static void construct(Alloc& alloc, pointer p, const value_type& value)
+	{
+		alloc.construct(p, value);
+	}
+	static void destroy(Alloc& alloc, pointer p) { alloc.destroy(p); }
+	static size_type max_size(const Alloc& alloc) { return alloc.max_size(); }
+#endif
+};
+
 } //internal
 
 template <bool, typename T = void> struct enable_if : public internal::not_enabled {};
@@ -53,6 +163,42 @@ template<> struct is_integral<unsigned long> : public internal::integral {};
 template<> struct is_integral<long long> : public internal::integral {};
 template<> struct is_integral<unsigned long long> : public internal::integral {};
 
+template<typename T>
+struct alignment_of {
+	struct helper {
+		char	c;
+		T		t;
+	};
+	static const std::size_t value = sizeof(helper) - sizeof(T);
+};
+
+#if defined(__GNUC__) || defined(__clang__)
+# define FT_IS_TRIVIALLY_COPYABLE(T) __is_trivially_copyable(T)
+#else
+# define FT_IS_TRIVIALLY_COPYABLE(T) false
+#endif
+
+// Types that can be moved to a new address with memcpy, leaving nothing to
+// destroy behind. Specialize it for user types that own no self references.
+template<typename T> struct is_trivially_relocatable :
+	public internal::bool_constant<is_integral<T>::value || FT_IS_TRIVIALLY_COPYABLE(T)> {};
+template<typename T> struct is_trivially_relocatable<const T> : public is_trivially_relocatable<T> {};
+template<typename T> struct is_trivially_relocatable<T*> : public internal::true_type {};
+template<> struct is_trivially_relocatable<bool> : public internal::true_type {};
+template<> struct is_trivially_relocatable<float> : public internal::true_type {};
+template<> struct is_trivially_relocatable<double> : public internal::true_type {};
+template<> struct is_trivially_relocatable<long double> : public internal::true_type {};
+
+// Allocators that can resize a block without copying it through the
+// element type provide pointer reallocate(pointer p, size_type old_n,
+// size_type new_n), returning NULL on failure, and specialize this.
+template<typename Alloc> struct has_reallocate : public internal::false_type {};
+
+// Tag for constructors taking a range the caller guarantees to be sorted
+// and free of duplicate keys.
+struct from_sorted_t {};
+static const from_sorted_t from_sorted = from_sorted_t();
+
 #define PAIR template<typename T, typename U>
 PAIR
 class pair
@@ -75,6 +221,19 @@ public:
 		first(other.first),
 		second(other.second)
 	{}
+#ifdef FT_CXX11
+	pair(pair&& other) = default;
+	template<typename T2, typename U2>
+	pair(T2&& x, U2&& y) :
+		first(std::forward<T2>(x)),
+		second(std::forward<U2>(y))
+	{}
+	template<typename T2, typename U2>
+	pair(pair<T2, U2>&& other) :
+		first(std::move(other.first)),
+		second(std::move(other.second))
+	{}
+#endif
 	~pair() {}
 
 	pair& operator=(const pair& other)
@@ -83,6 +242,14 @@ public:
 		second = other.second;
 		return *this;
 	}
+#ifdef FT_CXX11
+	pair& operator=(pair&& other)
+	{
+		first = std::move(other.first);
+		second = std::move(other.second);
+		return *this;
+	}
+#endif
 
 	T first;
 	U second;
@@ -111,6 +278,10 @@ PAIR bool operator>=(const pair<T, U>& lhs, const pair<T, U>& rhs){
 	return !(lhs < rhs);
 }
 
+PAIR struct is_trivially_relocatable<pair<T, U> > :
+	public internal::bool_constant<is_trivially_relocatable<T>::value
+								&& is_trivially_relocatable<U>::value> {};
+
 PAIR pair<T, U> make_pair(T x, U y) {
 	return pair<T, U>(x, y);
 }
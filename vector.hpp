@@ -3,114 +3,76 @@
 
 #include <memory>
 #include <stdexcept>
+#include <cstring>
 #include "iterator.hpp"
 #include "utils.hpp"
 #include "compare.hpp"
+#include "growth.hpp"
 
 namespace ft
 {
 
-template<typename T, typename Allocator = std::allocator<T> >
-class vector {
-public:
-	typedef T									value_type;
-	typedef Allocator							allocator_type;
-	typedef typename Allocator::reference		reference;
-	typedef typename Allocator::const_reference	const_reference;
-	typedef typename Allocator::pointer			pointer;
-	typedef typename Allocator::const_pointer	const_pointer;
-	typedef value_type*							iterator;
-	typedef const value_type*					const_iterator;
-	typedef ft::reverse_iterator<iterator>		reverse_iterator;
-	typedef ft::reverse_iterator<const_iterator>const_reverse_iterator;
-	typedef typename Allocator::size_type		size_type;
-	typedef typename Allocator::difference_type	difference_type;
-
-	vector() :
-		_data(NULL),
-		_size(0),
-		_capacity(0),
-		_alloc(Allocator())
-	{
-		reserve(0);
-	}
-	explicit vector(const Allocator& alloc) :
-		_data(NULL),
-		_size(0),
-		_capacity(0),
-		_alloc(alloc)
-	{
-		reserve(0);
-	}
-	explicit vector(size_type n) :
-		_data(NULL),
-		_size(0),
-		_capacity(0),
-		_alloc(Allocator())
-	{
-		reserve(n);
-		for (size_type i = 0; i < n; i++)
-			_alloc.construct(_data + i, value_type());
-		_size = n;
-	}
-	vector(size_type n, const T& value, const Allocator& alloc = Allocator()) :
-		_data(NULL),
-		_size(0),
-		_capacity(0),
-		_alloc(alloc)
-	{
-		reserve(n);
-		for (size_type i = 0; i < n; i++)
-			_alloc.construct(_data + i, value);
-		_size = n;
-	}
+namespace internal {
 
-	template<typename InputIt>
-	vector(InputIt first, InputIt last, const Allocator& alloc = Allocator(),
-	typename ft::enable_if<!ft::is_integral<InputIt>::value, InputIt>::type* = NULL) :
-		_data(NULL),
-		_size(0),
-		_capacity(0),
-		_alloc(alloc)
+// Moves n elements from src to dst, leaving src uninitialized.
+// The ranges may overlap.
+template<typename Alloc, typename Ptr, typename Size>
+void relocate(Alloc& alloc, Ptr dst, Ptr src, Size n, true_type)
+{
+	(void)alloc;
+	std::memmove(static_cast<void*>(dst), static_cast<const void*>(src), n * sizeof(*src));
+}
+template<typename Alloc, typename Ptr, typename Size>
+void relocate(Alloc& alloc, Ptr dst, Ptr src, Size n, false_type)
+{
+	if (dst < src)
 	{
-		size_type n = distance(first, last);
-		reserve(n);
-		for (size_type i = 0; i < n; ++i)
-			_alloc.construct(_data + i, *(first++));
-		_size = n;
+		for (Size i = 0; i < n; ++i)
+		{
+			alloc_traits<Alloc>::construct(alloc, dst + i, FT_MOVE(src[i]));
+			alloc_traits<Alloc>::destroy(alloc, src + i);
+		}
 	}
-
-	vector(const vector<T,Allocator>& other) :
-		_data(NULL),
-		_size(0),
-		_capacity(0),
-		_alloc(Allocator())
+	else
 	{
-		reserve(other.size());
-		for(size_type i = 0; i < other.size(); ++i)
-			_alloc.construct(_data + i, other[i]);
-		_size = other.size();
+		for (Size i = n; i > 0; --i)
+		{
+			alloc_traits<Alloc>::construct(alloc, dst + i - 1, FT_MOVE(src[i - 1]));
+			alloc_traits<Alloc>::destroy(alloc, src + i - 1);
+		}
 	}
+}
+template<typename Alloc, typename Ptr, typename Size>
+void relocate(Alloc& alloc, Ptr dst, Ptr src, Size n)
+{
+	if (n == 0 || dst == src)
+		return;
+	relocate(alloc, dst, src, n, ft::is_trivially_relocatable<typename alloc_traits<Alloc>::value_type>());
+}
 
-	~vector()
-	{
-		for(size_type i = 0; i < _size; ++i)
-			_alloc.destroy(_data + i);
-		_alloc.deallocate(_data, _capacity);
-	}
+// What ft::vector and ft::small_vector share. Derived owns the buffer
+// the elements start in, and tells through on_heap() whether the current
+// one came from the allocator and through reset_storage() how to get back
+// to the starting one once it is released.
+template<typename T, typename Allocator, typename Growth, typename Derived>
+class vector_base {
+protected:
+	typedef internal::alloc_traits<Allocator>	alloc_traits;
 
-	vector& operator=(const vector<T, Allocator>& other)
-	{
-		if (&other == this)
-			return *this;
-		clear();
-		if (other.size() > _capacity)
-			reserve(other.size());
-		for(size_type i = 0; i < other.size(); ++i)
-			_alloc.construct(_data + i, other[i]);
-		_size = other.size();
-		return *this;
-	}
+public:
+	typedef T										value_type;
+	typedef Allocator								allocator_type;
+	typedef typename alloc_traits::reference		reference;
+	typedef typename alloc_traits::const_reference	const_reference;
+	typedef typename alloc_traits::pointer			pointer;
+	typedef typename alloc_traits::const_pointer	const_pointer;
+	typedef value_type*								iterator;
+	typedef const value_type*						const_iterator;
+	typedef ft::reverse_iterator<iterator>			reverse_iterator;
+	typedef ft::reverse_iterator<const_iterator>const_reverse_iterator;
+	typedef typename alloc_traits::size_type		size_type;
+	typedef typename alloc_traits::difference_type	difference_type;
+	typedef Growth									growth_policy;
 
 	void assign(size_type count, const T& value)
 	{
@@ -118,7 +80,7 @@ public:
 		if (count > _capacity)
 			reserve(count);
 		for(size_type i = 0; i < count; ++i)
-			_alloc.construct(_data + i, value);
+			alloc_traits::construct(_alloc, _data + i, value);
 		_size = count;
 	}
 
@@ -126,13 +88,8 @@ public:
 	void assign(InputIt first, InputIt end,
 	typename ft::enable_if<!ft::is_integral<InputIt>::value, InputIt>::type* = NULL)
 	{
-		vector<value_type> cpy(first, end);
-		clear();
-		if (cpy.size() > _capacity)
-			reserve(cpy.size());
-		for(size_type i = 0; i < cpy.size(); ++i)
-			_alloc.construct(_data + i, cpy[i]);
-		_size = cpy.size();
+		range_assign(first, end,
+			internal::to_ft_category(typename ft::iterator_traits<InputIt>::iterator_category()));
 	}
 
 	allocator_type get_allocator() const {
@@ -175,21 +132,16 @@ public:
 	//Capacity
 	bool empty() const { return _size == 0; }
 	size_type size() const { return _size; }
-	size_type max_size() const { return _alloc.max_size(); }
+	// Element offsets must fit in difference_type
+	size_type max_size() const
+	{
+		return min(alloc_traits::max_size(_alloc), size_type(-1) / 2 / sizeof(value_type));
+	}
 	void reserve(size_type new_cap)
 	{
-		if (new_cap < _capacity)
+		if (new_cap <= _capacity)
 			return;
-		pointer res = _alloc.allocate(new_cap);
-
-		for (size_type i = 0; i < _size; ++i)
-		{
-			_alloc.construct(res + i, _data[i]);
-			_alloc.destroy(_data + i);
-		}
-		_alloc.deallocate(_data, _capacity);
-		_data = res;
-		_capacity = new_cap;
+		reallocate(new_cap);
 	}
 	size_type capacity() const { return _capacity; }
 
@@ -197,169 +149,530 @@ public:
 	void clear()
 	{
 		for (size_type i = 0; i < _size; i++)
-			_alloc.destroy(_data + i);
+			alloc_traits::destroy(_alloc, _data + i);
 		_size = 0;
 	}
 
 	iterator insert(const_iterator pos, const T& value)
 	{
-		size_type idx = distance(begin(), pos);
-		if (_size + 1 > _capacity)
-			reserve(max((size_type)1, _capacity * 2));
-		for (size_type i = _size; i > idx; --i)
+		return insert(pos, 1, value);
+	}
+	iterator insert(const_iterator pos, size_type count, const T& value)
+	{
+		size_type idx = pos - begin();
+		if (count == 0)
+			return begin() + idx;
+		if (_size + count > _capacity && !remap(next_capacity(_size + count), &value))
 		{
-			_alloc.construct(_data + i, _data[i - 1]);
-			_alloc.destroy(_data + i - 1);
+			size_type new_cap = next_capacity(_size + count);
+			pointer res = _alloc.allocate(new_cap);
+			for (size_type i = idx; i < idx + count; ++i)
+				alloc_traits::construct(_alloc, res + i, value);
+			adopt(res, new_cap, idx, count);
 		}
-		_alloc.construct(_data + idx, value);
-		++_size;
+		else
+		{
+			const T* src = &value;
+			if (src >= _data + idx && src < _data + _size)
+				src += count;
+			relocate(_data + idx + count, _data + idx, _size - idx);
+			for (size_type i = idx; i < idx + count; ++i)
+				alloc_traits::construct(_alloc, _data + i, *src);
+		}
+		_size += count;
 		return begin() + idx;
 	}
-	iterator insert(const_iterator pos, size_type count, const T& value)
+#ifdef FT_CXX11
+	iterator insert(const_iterator pos, T&& value)
+	{
+		return emplace(pos, std::move(value));
+	}
+
+	template<typename... Args>
+	iterator emplace(const_iterator pos, Args&&... args)
 	{
-		size_type idx = distance(begin(), pos);
-		if (_size + count > _capacity)
-			reserve(_capacity + max(count, _capacity));
-		if (_size > 0)
+		size_type idx = pos - begin();
+		if (_size + 1 > _capacity)
+			grow_emplace(idx, std::forward<Args>(args)...);
+		else if (idx == _size)
+			alloc_traits::construct(_alloc, _data + idx, std::forward<Args>(args)...);
+		else
 		{
-			for (size_type i = min(_size, idx + count) - 1; i >= idx; --i)
-			{
-				_alloc.construct(_data + i + count, _data[i]);
-				_alloc.destroy(_data + i);
-			}
+			value_type tmp(std::forward<Args>(args)...);
+			relocate(_data + idx + 1, _data + idx, _size - idx);
+			alloc_traits::construct(_alloc, _data + idx, std::move(tmp));
 		}
-		for (size_type i = idx; i < idx + count; ++i)
-			_alloc.construct(_data + i, value);
-		_size += count;
+		++_size;
 		return begin() + idx;
 	}
+#endif
 
 	template<class InputIt>
 	iterator insert(const_iterator pos, InputIt first, InputIt last,
 	typename ft::enable_if<!ft::is_integral<InputIt>::value, InputIt>::type* = NULL)
 	{
-		size_type idx = distance(begin(), pos);
-		vector<value_type> cpy(first, last);
-
-		if (_size + cpy.size() > _capacity)
-			reserve(_capacity + cpy.size());
-		if (_size > 0)
-		{
-			for (size_type i = min(_size, idx + cpy.size()) - 1; i >= idx; --i)
-			{
-				_alloc.construct(_data + i + cpy.size(), _data[i]);
-				_alloc.destroy(_data + i);
-			}
-		}
-		for (size_type i = 0; i < cpy.size(); ++i)
-			_alloc.construct(_data + idx + i, cpy[i]);
-		_size += cpy.size();
-		return begin() + idx;
+		return range_insert(pos - begin(), first, last,
+			internal::to_ft_category(typename ft::iterator_traits<InputIt>::iterator_category()));
 	}
 
 	iterator erase(iterator pos)
 	{
-		size_type idx = distance(begin(), pos);
-		_alloc.destroy(_data + idx);
-		for (size_type i = idx; i < _size - 1; ++i)
-		{
-			_alloc.construct(_data + i, _data[i + 1]);
-			_alloc.destroy(_data + i + 1);
-		}
+		size_type idx = pos - begin();
+		alloc_traits::destroy(_alloc, _data + idx);
+		relocate(_data + idx, _data + idx + 1, _size - idx - 1);
 		--_size;
+		shrink();
 		return begin() + idx;
 	}
 	iterator erase(iterator first, iterator last)
 	{
-		size_type idx = distance(begin(), first);
-		size_type count = distance(first, last);
+		size_type idx = first - begin();
+		size_type count = last - first;
 		for(size_type i = idx; i < count + idx; ++i)
-			_alloc.destroy(_data + i);
-		for (size_type i = idx; i < _size - count; ++i)
-		{
-			_alloc.construct(_data + i, _data[i + count]);
-			_alloc.destroy(_data + i + count);
-		}
+			alloc_traits::destroy(_alloc, _data + i);
+		relocate(_data + idx, _data + idx + count, _size - idx - count);
 		_size -= count;
+		shrink();
 		return begin() + idx;
 	}
 
 	void push_back(const T& value)
 	{
-		if (_size + 1 > _capacity)
-			reserve(max((size_type)1, _capacity * 2));
-		_alloc.construct(_data + _size, value);
+		if (_size + 1 > _capacity && !remap(next_capacity(_size + 1), &value))
+		{
+			size_type new_cap = next_capacity(_size + 1);
+			pointer res = _alloc.allocate(new_cap);
+			alloc_traits::construct(_alloc, res + _size, value);
+			adopt(res, new_cap, _size, 1);
+		}
+		else
+			alloc_traits::construct(_alloc, _data + _size, value);
 		++_size;
 	}
+#ifdef FT_CXX11
+	void push_back(T&& value)
+	{
+		emplace_back(std::move(value));
+	}
+
+	template<typename... Args>
+	reference emplace_back(Args&&... args)
+	{
+		if (_size + 1 > _capacity)
+			grow_emplace(_size, std::forward<Args>(args)...);
+		else
+			alloc_traits::construct(_alloc, _data + _size, std::forward<Args>(args)...);
+		return _data[_size++];
+	}
+#endif
 
 	void pop_back()
 	{
 		--_size;
-		_alloc.destroy(_data + _size);
+		alloc_traits::destroy(_alloc, _data + _size);
+		shrink();
 	}
 
 	void resize(size_type count, T value = T())
 	{
 		if (count > _capacity)
-			reserve(max(count, _capacity * 2));
+			reserve(next_capacity(count));
 		for (size_type i = count; i < _size; i++)
-			_alloc.destroy(_data + i);
+			alloc_traits::destroy(_alloc, _data + i);
 		for (size_type i = _size; i < count; i++)
-			_alloc.construct(_data + i, value);
+			alloc_traits::construct(_alloc, _data + i, value);
 		_size = count;
+		shrink();
 	}
 
-	void swap(vector<T>& other)
+protected:
+	vector_base(pointer data, size_type capacity, const Allocator& alloc) :
+		_data(data),
+		_size(0),
+		_capacity(capacity),
+		_alloc(alloc)
 	{
-		if (&other == this)
+	}
+
+	void init(size_type n, const T& value)
+	{
+		reserve(n);
+		for (size_type i = 0; i < n; i++)
+			alloc_traits::construct(_alloc, _data + i, value);
+		_size = n;
+	}
+	void copy_init(const vector_base& other)
+	{
+		reserve(other.size());
+		for(size_type i = 0; i < other.size(); ++i)
+			alloc_traits::construct(_alloc, _data + i, other[i]);
+		_size = other.size();
+	}
+	void copy_assign(const vector_base& other)
+	{
+		clear();
+		if (other.size() > _capacity)
+			reserve(other.size());
+		for(size_type i = 0; i < other.size(); ++i)
+			alloc_traits::construct(_alloc, _data + i, other[i]);
+		_size = other.size();
+	}
+
+	template<typename InputIt>
+	void range_init(InputIt first, InputIt last, ft::input_iterator_tag)
+	{
+		for (; first != last; ++first)
+			push_back(*first);
+	}
+	template<typename ForwardIt>
+	void range_init(ForwardIt first, ForwardIt last, ft::forward_iterator_tag)
+	{
+		size_type n = ft::distance(first, last);
+		reserve(n);
+		for (; _size < n; ++_size, ++first)
+			alloc_traits::construct(_alloc, _data + _size, *first);
+	}
+
+	template<typename InputIt>
+	void range_assign(InputIt first, InputIt last, ft::input_iterator_tag)
+	{
+		clear();
+		for (; first != last; ++first)
+			push_back(*first);
+	}
+	template<typename ForwardIt>
+	void range_assign(ForwardIt first, ForwardIt last, ft::forward_iterator_tag)
+	{
+		if (aliases(first))
+		{
+			Derived cpy(first, last, _alloc);
+			derived().swap(cpy);
 			return;
-		ft::swap(_data, other._data);
-		ft::swap(_size, other._size);
-		ft::swap(_capacity, other._capacity);
-		ft::swap(_alloc, other._alloc);
+		}
+		clear();
+		size_type n = ft::distance(first, last);
+		if (n > _capacity)
+		{
+			release();
+			derived().reset_storage();
+			reserve(n);
+		}
+		for (; _size < n; ++_size, ++first)
+			alloc_traits::construct(_alloc, _data + _size, *first);
 	}
 
-private:
+	template<typename InputIt>
+	iterator range_insert(size_type idx, InputIt first, InputIt last, ft::input_iterator_tag)
+	{
+		if (idx == _size)
+		{
+			for (; first != last; ++first)
+				push_back(*first);
+			return begin() + idx;
+		}
+		Derived cpy(first, last, _alloc);
+		return range_insert(idx, cpy.begin(), cpy.end(), ft::random_access_iterator_tag());
+	}
+	template<typename ForwardIt>
+	iterator range_insert(size_type idx, ForwardIt first, ForwardIt last, ft::forward_iterator_tag)
+	{
+		size_type count = ft::distance(first, last);
+		if (count == 0)
+			return begin() + idx;
+		if (_size + count > _capacity
+			&& (aliases(first) || !remap(next_capacity(_size + count))))
+		{
+			size_type new_cap = next_capacity(_size + count);
+			pointer res = _alloc.allocate(new_cap);
+			for (size_type i = 0; i < count; ++i, ++first)
+				alloc_traits::construct(_alloc, res + idx + i, *first);
+			adopt(res, new_cap, idx, count);
+		}
+		else if (aliases(first))
+		{
+			Derived cpy(first, last, _alloc);
+			return range_insert(idx, cpy.begin(), cpy.end(), ft::random_access_iterator_tag());
+		}
+		else
+		{
+			relocate(_data + idx + count, _data + idx, _size - idx);
+			for (size_type i = 0; i < count; ++i, ++first)
+				alloc_traits::construct(_alloc, _data + idx + i, *first);
+		}
+		_size += count;
+		return begin() + idx;
+	}
+
+	// Whether an incoming range points into our own storage
+	bool aliases(const_pointer it) const { return it >= _data && it < _data + _capacity; }
+	bool aliases(pointer it) const { return it >= _data && it < _data + _capacity; }
+	template<typename Iter>
+	bool aliases(const Iter&) const { return false; }
+
+	size_type next_capacity(size_type required) const
+	{
+		return max(required, Growth::grow(_size, required, (size_type)sizeof(value_type)));
+	}
+
+	// Gives memory back when the growth policy asks for it
+	void shrink()
+	{
+		size_type new_cap = Growth::shrink(_size, _capacity);
+		if (new_cap < _capacity)
+			reallocate(max(new_cap, _size));
+	}
+
+	void reallocate(size_type new_cap)
+	{
+		if (new_cap && remap(new_cap))
+			return;
+		pointer res = NULL;
+		if (new_cap)
+			res = _alloc.allocate(new_cap);
+		relocate(res, _data, _size);
+		release();
+		_data = res;
+		_capacity = new_cap;
+	}
+
+	typedef internal::bool_constant<ft::has_reallocate<Allocator>::value
+		&& ft::is_trivially_relocatable<value_type>::value>	can_remap;
+
+	// Resizes the buffer through the allocator's reallocate when it has one
+	// and the elements can be moved bitwise. Fails when ref, an argument the
+	// caller still needs, points into the buffer.
+	bool remap(size_type new_cap, const void* ref = NULL)
+	{
+		return remap(new_cap, ref, can_remap());
+	}
+	bool remap(size_type new_cap, const void* ref, internal::true_type)
+	{
+		if (!derived().on_heap() || (ref >= _data && ref < _data + _capacity))
+			return false;
+		pointer res = _alloc.reallocate(_data, _capacity, new_cap);
+		if (!res)
+			return false;
+		_data = res;
+		_capacity = new_cap;
+		return true;
+	}
+	bool remap(size_type, const void*, internal::false_type)
+	{
+		return false;
+	}
+
+#ifdef FT_CXX11
+	// Inserts an element at idx into a full buffer. args may refer into the
+	// buffer, which remapping moves, so the element is built first then.
+	template<typename... Args>
+	void grow_emplace(size_type idx, Args&&... args)
+	{
+		const size_type new_cap = next_capacity(_size + 1);
+		if (can_remap::value)
+		{
+			value_type tmp(std::forward<Args>(args)...);
+			if (remap(new_cap))
+			{
+				relocate(_data + idx + 1, _data + idx, _size - idx);
+				alloc_traits::construct(_alloc, _data + idx, std::move(tmp));
+				return;
+			}
+			pointer res = _alloc.allocate(new_cap);
+			alloc_traits::construct(_alloc, res + idx, std::move(tmp));
+			adopt(res, new_cap, idx, 1);
+			return;
+		}
+		pointer res = _alloc.allocate(new_cap);
+		alloc_traits::construct(_alloc, res + idx, std::forward<Args>(args)...);
+		adopt(res, new_cap, idx, 1);
+	}
+#endif
+
+	// Switches to the new buffer res, whose elements [idx, idx + gap) are
+	// already constructed, moving the current elements around that gap.
+	void adopt(pointer res, size_type new_cap, size_type idx, size_type gap)
+	{
+		relocate(res, _data, idx);
+		relocate(res + idx + gap, _data + idx, _size - idx);
+		release();
+		_data = res;
+		_capacity = new_cap;
+	}
+
+	void relocate(pointer dst, pointer src, size_type n)
+	{
+		internal::relocate(_alloc, dst, src, n);
+	}
+
+	void release()
+	{
+		if (derived().on_heap())
+			_alloc.deallocate(_data, _capacity);
+	}
+
+	Derived& derived() { return static_cast<Derived&>(*this); }
+	const Derived& derived() const { return static_cast<const Derived&>(*this); }
+
 	pointer			_data;
 	size_type		_size;
 	size_type		_capacity;
 	allocator_type	_alloc;
 };
 
-template<typename T, typename A>
-bool operator==(const vector<T, A>& a, const vector<T, A>& b)
+} //internal
+
+template<typename T, typename Allocator = std::allocator<T>, typename Growth = ft::growth_double>
+class vector : public internal::vector_base<T, Allocator, Growth, vector<T, Allocator, Growth> > {
+	typedef internal::vector_base<T, Allocator, Growth, vector>	base;
+	friend class internal::vector_base<T, Allocator, Growth, vector>;
+
+public:
+	typedef typename base::value_type				value_type;
+	typedef typename base::allocator_type			allocator_type;
+	typedef typename base::reference				reference;
+	typedef typename base::const_reference			const_reference;
+	typedef typename base::pointer					pointer;
+	typedef typename base::const_pointer			const_pointer;
+	typedef typename base::iterator					iterator;
+	typedef typename base::const_iterator			const_iterator;
+	typedef typename base::reverse_iterator			reverse_iterator;
+	typedef typename base::const_reverse_iterator	const_reverse_iterator;
+	typedef typename base::size_type				size_type;
+	typedef typename base::difference_type			difference_type;
+	typedef Growth									growth_policy;
+
+	vector() :
+		base(NULL, 0, Allocator())
+	{
+	}
+	explicit vector(const Allocator& alloc) :
+		base(NULL, 0, alloc)
+	{
+	}
+	explicit vector(size_type n) :
+		base(NULL, 0, Allocator())
+	{
+		this->init(n, value_type());
+	}
+	vector(size_type n, const T& value, const Allocator& alloc = Allocator()) :
+		base(NULL, 0, alloc)
+	{
+		this->init(n, value);
+	}
+
+	template<typename InputIt>
+	vector(InputIt first, InputIt last, const Allocator& alloc = Allocator(),
+	typename ft::enable_if<!ft::is_integral<InputIt>::value, InputIt>::type* = NULL) :
+		base(NULL, 0, alloc)
+	{
+		this->range_init(first, last,
+			internal::to_ft_category(typename ft::iterator_traits<InputIt>::iterator_category()));
+	}
+
+	vector(const vector& other) :
+		base(NULL, 0, other._alloc)
+	{
+		this->copy_init(other);
+	}
+
+#ifdef FT_CXX11
+	vector(vector&& other) :
+		base(other._data, other._capacity, other._alloc)
+	{
+		this->_size = other._size;
+		other.reset_storage();
+		other._size = 0;
+	}
+#endif
+
+	~vector()
+	{
+		this->clear();
+		this->release();
+	}
+
+	vector& operator=(const vector& other)
+	{
+		if (&other != this)
+			this->copy_assign(other);
+		return *this;
+	}
+#ifdef FT_CXX11
+	vector& operator=(vector&& other)
+	{
+		if (&other == this)
+			return *this;
+		this->clear();
+		this->release();
+		this->_data = other._data;
+		this->_size = other._size;
+		this->_capacity = other._capacity;
+		this->_alloc = std::move(other._alloc);
+		other.reset_storage();
+		other._size = 0;
+		return *this;
+	}
+#endif
+
+	void shrink_to_fit()
+	{
+		if (this->_capacity > this->_size)
+			this->reallocate(this->_size);
+	}
+
+	void swap(vector& other)
+	{
+		if (&other == this)
+			return;
+		ft::swap(this->_data, other._data);
+		ft::swap(this->_size, other._size);
+		ft::swap(this->_capacity, other._capacity);
+		ft::swap(this->_alloc, other._alloc);
+	}
+
+private:
+	bool on_heap() const { return this->_data != NULL; }
+	void reset_storage()
+	{
+		this->_data = NULL;
+		this->_capacity = 0;
+	}
+};
+
+template<typename T, typename A, typename G>
+bool operator==(const vector<T, A, G>& a, const vector<T, A, G>& b)
 {
 	if (a.size() != b.size())
 		return false;
 	return ft::equal(a.begin(), a.end(), b.begin());
 }
 
-template<typename T, typename A>
-bool operator!=(const vector<T, A>& a, const vector<T, A>& b)
+template<typename T, typename A, typename G>
+bool operator!=(const vector<T, A, G>& a, const vector<T, A, G>& b)
 {
 	return !(a == b);
 }
 
-template<typename T, typename A>
-bool operator<(const vector<T, A>& a, const vector<T, A>& b)
+template<typename T, typename A, typename G>
+bool operator<(const vector<T, A, G>& a, const vector<T, A, G>& b)
 {
 	return ft::lexicographical_compare(a.begin(), a.end(), b.begin(), b.end());
 }
 
-template<typename T, typename A>
-bool operator>(const vector<T, A>& a, const vector<T, A>& b)
+template<typename T, typename A, typename G>
+bool operator>(const vector<T, A, G>& a, const vector<T, A, G>& b)
 {
 	return (b < a);
 }
 
-template<typename T, typename A>
-bool operator<=(const vector<T, A>& a, const vector<T, A>& b)
+template<typename T, typename A, typename G>
+bool operator<=(const vector<T, A, G>& a, const vector<T, A, G>& b)
 {
 	return !(a > b);
 }
 
-template<typename T, typename A>
-bool operator>=(const vector<T, A>& a, const vector<T, A>& b)
+template<typename T, typename A, typename G>
+bool operator>=(const vector<T, A, G>& a, const vector<T, A, G>& b)
 {
 	return !(a < b);
 }